@@ -15,13 +15,13 @@ let package = Package(
     targets: [
         Target(name: "TarantoolConnector", dependencies: ["Tarantool"]),
         Target(name: "TarantoolModule", dependencies: ["CTarantool", "Tarantool"]),
-        Target(name: "AsyncTarantool", dependencies: ["CTarantool", "TarantoolModule"])
+        Target(name: "AsyncTarantool", dependencies: ["CTarantool", "TarantoolModule", "TarantoolConnector"]),
+        Target(name: "TarantoolBenchmark", dependencies: ["TarantoolConnector"])
     ],
     dependencies: [
         .Package(url: "https://github.com/tris-foundation/async.git", majorVersion: 0),
         .Package(url: "https://github.com/tris-foundation/socket.git", majorVersion: 0),
         .Package(url: "https://github.com/tris-foundation/messagepack.git", majorVersion: 0),
-        .Package(url: "https://github.com/tris-foundation/cryptoswift.git", majorVersion: 0),
     ]
 )
 
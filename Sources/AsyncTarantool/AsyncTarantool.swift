@@ -10,7 +10,9 @@
 
 import Async
 import CTarantool
+import Foundation
 import TarantoolModule
+import TarantoolConnector
 
 public struct TarantoolLoop: AsyncLoop {
     public func run() {
@@ -21,19 +23,39 @@ public struct TarantoolLoop: AsyncLoop {
 public struct AsyncTarantool: Async {
     public init() {}
     public var loop: AsyncLoop = TarantoolLoop()
-    public var task: (@escaping AsyncTask) -> Void = fiber
+    // AsyncTask can't report a failure, so a fiber that could not
+    // be created is at least logged
+    public var task: (@escaping AsyncTask) -> Void = { task in
+        guard fiber(task) else {
+            Say.error(message: "can't create fiber: \(BoxError())")
+            return
+        }
+    }
     public var awaiter: IOAwaiter? = TarantoolAwaiter()
 }
 
-public struct TarantoolAwaiterTimeout: Error {
+public struct TarantoolAwaiterTimeout: IOWaitError {
+    public var isTimeout: Bool {
+        return true
+    }
+}
 
+public struct TarantoolAwaiterCancelled: IOWaitError {
+    public var isTimeout: Bool {
+        return false
+    }
 }
 
 public struct TarantoolAwaiter: IOAwaiter {
-    public init() {}
+    // seconds a single socket wait may take
+    public var timeout: Double
+
+    public init(timeout: Double = Timeout.infinity) {
+        self.timeout = timeout
+    }
 
-    struct Timeout {
-        static let infinity: Double = 100*365*24*3600
+    public struct Timeout {
+        public static let infinity: Double = 100*365*24*3600
     }
 
     struct COIOEvent {
@@ -42,15 +64,34 @@ public struct TarantoolAwaiter: IOAwaiter {
     }
 
     public func wait(for descriptor: Int32, event: IOEvent) throws {
+        guard try wait(for: descriptor, event: event, timeout: timeout) else {
+            throw TarantoolAwaiterTimeout()
+        }
+    }
+
+    // false on timeout
+    func wait(for descriptor: Int32, event: IOEvent, timeout: Double) throws -> Bool {
+        let expected: Int32
         switch event {
-        case .read:
-            guard COIOEvent.read == coio_wait(descriptor, COIOEvent.read, Timeout.infinity) else {
-                throw TarantoolAwaiterTimeout()
-            }
-        case .write:
-            guard COIOEvent.write == coio_wait(descriptor, COIOEvent.write, Timeout.infinity) else {
-                throw TarantoolAwaiterTimeout()
-            }
+        case .read: expected = COIOEvent.read
+        case .write: expected = COIOEvent.write
+        }
+        let result = coio_wait(descriptor, expected, timeout)
+        // coio_wait is a cancellation point
+        guard !fiber_is_cancelled() else {
+            throw TarantoolAwaiterCancelled()
+        }
+        return result == expected
+    }
+}
+
+extension TarantoolAwaiter: DeadlineAwaiter {
+    // bounded by both the deadline and the per-wait timeout
+    public func wait(for descriptor: Int32, event: IOEvent, deadline: Date) throws -> Bool {
+        let remaining = deadline.timeIntervalSinceNow
+        guard remaining > 0 else {
+            return false
         }
+        return try wait(for: descriptor, event: event, timeout: min(remaining, timeout))
     }
 }
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import TarantoolModule
+import TarantoolConnector
+
+extension IProtoConnection {
+    // Connection for use inside tarantool: the socket waits in coio,
+    // a reader fiber dispatches responses by sync and requesting fibers
+    // sleep until fiber_wakeup, so many of them share one connection.
+    public convenience init(host: String, port: UInt16 = 3301, async: AsyncTarantool) throws {
+        try self.init(host: host, port: port, awaiter: async.awaiter, condition: FiberCondition())
+        try startReader { reader in
+            guard fiber(reader) else {
+                throw BoxError()
+            }
+        }
+    }
+}
+
+// Runs every closure in its own fiber and waits for all of them.
+// Results keep the order of the closures, the first error is rethrown
+// only after every fiber has finished.
+public func gather<T>(_ tasks: [(Void) throws -> T]) throws -> [T] {
+    guard !tasks.isEmpty else {
+        return []
+    }
+
+    var results = [T?](repeating: nil, count: tasks.count)
+    var firstError: Error?
+    var remaining = tasks.count
+    let done = FiberCondition()
+
+    for (index, task) in tasks.enumerated() {
+        let started = fiber {
+            do {
+                results[index] = try task()
+            } catch {
+                if firstError == nil {
+                    firstError = error
+                }
+            }
+            remaining -= 1
+            if remaining == 0 {
+                done.broadcast()
+            }
+        }
+        guard started else {
+            // e.g. out of memory, the task never runs
+            if firstError == nil {
+                firstError = BoxError()
+            }
+            remaining -= 1
+            continue
+        }
+    }
+
+    while remaining > 0 {
+        done.wait()
+    }
+
+    if let error = firstError {
+        throw error
+    }
+    return results.map { $0! }
+}
@@ -47,6 +47,7 @@
  */
 
 #include <stddef.h>
+#include <stdarg.h> /* va_list */
 #include <errno.h>
 #include <string.h> /* strerror(3) */
 #include <stdint.h>
@@ -86,6 +87,12 @@ typedef int (*fiber_func)(va_list);
 struct fiber *
 (*fiber_new)(const char *name, fiber_func f);
 
+/**
+ * Return the current fiber
+ */
+struct fiber *
+(*fiber_self)(void);
+
 /**
  * Return control to another fiber and wait until it'll be woken.
  *
@@ -256,6 +263,8 @@ int
  *	...
  * @endcode
  */
+ssize_t
+(*coio_call)(ssize_t (*func)(va_list), ...);
 
 struct addrinfo;
 
@@ -11,5 +11,6 @@
 #include <module.h>
 
 void tarantool_module_init();
-void fiber_wrapper(void* ctx, void (*closure)(void*));
+int fiber_wrapper(const char* name, void* ctx, void (*closure)(void*));
+int coio_call_wrapper(void* ctx, void (*closure)(void*));
 void say_wrapper(int level, const char* file, int line, const char* message);
@@ -34,6 +34,7 @@ void tarantool_module_init() {
 
     resolve(handle, "sayfunc", (void**)&sayfunc);
     resolve(handle, "fiber_new", (void**)&fiber_new);
+    resolve(handle, "fiber_self", (void**)&fiber_self);
     resolve(handle, "fiber_yield", (void**)&fiber_yield);
     resolve(handle, "fiber_start", (void**)&fiber_start);
     resolve(handle, "fiber_wakeup", (void**)&fiber_wakeup);
@@ -50,6 +51,7 @@ void tarantool_module_init() {
     resolve(handle, "coio_wait", (void**)&coio_wait);
     resolve(handle, "coio_close", (void**)&coio_close);
     resolve(handle, "coio_getaddrinfo", (void**)&coio_getaddrinfo);
+    resolve(handle, "coio_call", (void**)&coio_call);
     resolve(handle, "box_txn", (void**)&box_txn);
     resolve(handle, "box_txn_begin", (void**)&box_txn_begin);
     resolve(handle, "box_txn_commit", (void**)&box_txn_commit);
@@ -121,9 +123,23 @@ int fiber_invoke(va_list ap) {
     return 0;
 }
 
-void fiber_wrapper(void* ctx, void (*closure)(void*)) {
-    struct fiber *swift_closure = fiber_new("fiber_wrapper", fiber_invoke);
+int fiber_wrapper(const char* name, void* ctx, void (*closure)(void*)) {
+    struct fiber *swift_closure = fiber_new(name, fiber_invoke);
+    if (swift_closure == NULL)
+        return -1;
     fiber_start(swift_closure, ctx, closure);
+    return 0;
+}
+
+ssize_t coio_invoke(va_list ap) {
+    void *ctx = va_arg(ap, void*);
+    void (*closure)(void*) = va_arg(ap, void*);
+    closure(ctx);
+    return 0;
+}
+
+int coio_call_wrapper(void* ctx, void (*closure)(void*)) {
+    return (int)coio_call(coio_invoke, ctx, closure);
 }
 
 void say_wrapper(int level, const char* file, int line, const char* message) {
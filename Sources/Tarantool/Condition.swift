@@ -0,0 +1,33 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+
+// Parks a caller until another one changes the shared state.
+// NSCondition is used for threads, FiberCondition from TarantoolModule
+// for fibers, where lock/unlock are no-ops and wait() yields.
+public protocol Condition: class {
+    func lock()
+    func unlock()
+    func wait()
+    // returns false if the deadline passed before broadcast
+    func wait(until deadline: Date) -> Bool
+    func broadcast()
+    // the waiting caller was asked to stop, e.g. by fiber_cancel
+    var isCancelled: Bool { get }
+}
+
+extension Condition {
+    public var isCancelled: Bool {
+        return false
+    }
+}
+
+extension NSCondition: Condition {}
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import MessagePack
+import Foundation
+
+// Decodes MessagePack in place from borrowed memory,
+// e.g. a connection buffer or a box tuple, without copying it first.
+public struct MessagePackReader {
+    let bytes: UnsafeBufferPointer<UInt8>
+    public private(set) var position = 0
+
+    public init(bytes: UnsafeBufferPointer<UInt8>) {
+        self.bytes = bytes
+    }
+
+    public var isEmpty: Bool {
+        return position >= bytes.count
+    }
+
+    public var remaining: UnsafeBufferPointer<UInt8> {
+        return UnsafeBufferPointer(start: bytes.baseAddress! + position, count: bytes.count - position)
+    }
+
+    mutating func readByte() throws -> UInt8 {
+        guard position < bytes.count else {
+            throw MessagePackError.insufficientData
+        }
+        let byte = bytes[position]
+        position += 1
+        return byte
+    }
+
+    mutating func readUInt(size: Int) throws -> UInt64 {
+        guard position + size <= bytes.count else {
+            throw MessagePackError.insufficientData
+        }
+        var value: UInt64 = 0
+        for i in 0..<size {
+            value = value << 8 | UInt64(bytes[position + i])
+        }
+        position += size
+        return value
+    }
+
+    mutating func readBytes(count: Int) throws -> UnsafeBufferPointer<UInt8> {
+        guard count >= 0, position + count <= bytes.count else {
+            throw MessagePackError.insufficientData
+        }
+        let slice = UnsafeBufferPointer(start: bytes.baseAddress! + position, count: count)
+        position += count
+        return slice
+    }
+
+    public func peek() throws -> UInt8 {
+        guard position < bytes.count else {
+            throw MessagePackError.insufficientData
+        }
+        return bytes[position]
+    }
+
+    public mutating func decodeNil() throws -> Bool {
+        guard try peek() == 0xc0 else {
+            return false
+        }
+        position += 1
+        return true
+    }
+
+    public mutating func decodeBool() throws -> Bool {
+        switch try readByte() {
+        case 0xc2: return false
+        case 0xc3: return true
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeInt() throws -> Int {
+        let byte = try readByte()
+        switch byte {
+        case 0x00...0x7f: return Int(byte)
+        case 0xe0...0xff: return Int(Int8(bitPattern: byte))
+        case 0xcc: return Int(try readUInt(size: 1))
+        case 0xcd: return Int(try readUInt(size: 2))
+        case 0xce: return Int(try readUInt(size: 4))
+        case 0xcf:
+            let value = try readUInt(size: 8)
+            guard value <= UInt64(Int.max) else {
+                throw MessagePackError.invalidData
+            }
+            return Int(value)
+        case 0xd0: return Int(Int8(truncatingBitPattern: try readUInt(size: 1)))
+        case 0xd1: return Int(Int16(truncatingBitPattern: try readUInt(size: 2)))
+        case 0xd2: return Int(Int32(truncatingBitPattern: try readUInt(size: 4)))
+        case 0xd3: return Int(Int64(bitPattern: try readUInt(size: 8)))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeDouble() throws -> Double {
+        switch try readByte() {
+        case 0xca: return Double(Float(bitPattern: UInt32(try readUInt(size: 4))))
+        case 0xcb: return Double(bitPattern: try readUInt(size: 8))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeStringBytes() throws -> UnsafeBufferPointer<UInt8> {
+        let byte = try readByte()
+        switch byte {
+        case 0xa0...0xbf: return try readBytes(count: Int(byte & 0x1f))
+        case 0xd9: return try readBytes(count: Int(try readUInt(size: 1)))
+        case 0xda: return try readBytes(count: Int(try readUInt(size: 2)))
+        case 0xdb: return try readBytes(count: Int(try readUInt(size: 4)))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeString() throws -> String {
+        let bytes = try decodeStringBytes()
+        guard let string = String(bytes: bytes, encoding: .utf8) else {
+            throw MessagePackError.invalidData
+        }
+        return string
+    }
+
+    public mutating func decodeBinaryBytes() throws -> UnsafeBufferPointer<UInt8> {
+        switch try readByte() {
+        case 0xc4: return try readBytes(count: Int(try readUInt(size: 1)))
+        case 0xc5: return try readBytes(count: Int(try readUInt(size: 2)))
+        case 0xc6: return try readBytes(count: Int(try readUInt(size: 4)))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeArrayCount() throws -> Int {
+        let byte = try readByte()
+        switch byte {
+        case 0x90...0x9f: return Int(byte & 0x0f)
+        case 0xdc: return Int(try readUInt(size: 2))
+        case 0xdd: return Int(try readUInt(size: 4))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    public mutating func decodeMapCount() throws -> Int {
+        let byte = try readByte()
+        switch byte {
+        case 0x80...0x8f: return Int(byte & 0x0f)
+        case 0xde: return Int(try readUInt(size: 2))
+        case 0xdf: return Int(try readUInt(size: 4))
+        default: throw MessagePackError.invalidData
+        }
+    }
+
+    mutating func decodeExtended(size: Int) throws -> MessagePack {
+        let type = Int8(bitPattern: try readByte())
+        let data = try readBytes(count: size)
+        return .extended(MessagePack.Extended(type: type, data: [UInt8](data)))
+    }
+
+    public mutating func decode() throws -> MessagePack {
+        let byte = try peek()
+        switch byte {
+        case 0x00...0x7f, 0xe0...0xff, 0xd0...0xd3:
+            return .int(try decodeInt())
+        case 0xcc...0xcf:
+            position += 1
+            let value = try readUInt(size: 1 << Int(byte - 0xcc))
+            guard value <= UInt64(Int.max) else {
+                return .uint(UInt(value))
+            }
+            return .int(Int(value))
+        case 0xc0:
+            position += 1
+            return .nil
+        case 0xc2, 0xc3:
+            return .bool(try decodeBool())
+        case 0xca:
+            position += 1
+            return .float(Float(bitPattern: UInt32(try readUInt(size: 4))))
+        case 0xcb:
+            return .double(try decodeDouble())
+        case 0xa0...0xbf, 0xd9...0xdb:
+            return .string(try decodeString())
+        case 0xc4...0xc6:
+            return .binary([UInt8](try decodeBinaryBytes()))
+        case 0x90...0x9f, 0xdc, 0xdd:
+            let count = try decodeArrayCount()
+            var array = [MessagePack]()
+            array.reserveCapacity(count)
+            for _ in 0..<count {
+                array.append(try decode())
+            }
+            return .array(array)
+        case 0x80...0x8f, 0xde, 0xdf:
+            let count = try decodeMapCount()
+            var map = [MessagePack : MessagePack](minimumCapacity: count)
+            for _ in 0..<count {
+                let key = try decode()
+                map[key] = try decode()
+            }
+            return .map(map)
+        case 0xd4...0xd8:
+            position += 1
+            return try decodeExtended(size: 1 << Int(byte - 0xd4))
+        case 0xc7...0xc9:
+            position += 1
+            let size = Int(try readUInt(size: 1 << Int(byte - 0xc7)))
+            return try decodeExtended(size: size)
+        default:
+            throw MessagePackError.invalidData
+        }
+    }
+
+    // moves past the next value without decoding it
+    public mutating func skip() throws {
+        let byte = try readByte()
+        switch byte {
+        case 0x00...0x7f, 0xe0...0xff, 0xc0, 0xc2, 0xc3:
+            break
+        case 0xcc, 0xd0: position += 1
+        case 0xcd, 0xd1: position += 2
+        case 0xce, 0xd2, 0xca: position += 4
+        case 0xcf, 0xd3, 0xcb: position += 8
+        case 0xa0...0xbf: position += Int(byte & 0x1f)
+        case 0xd9, 0xc4: position += Int(try readUInt(size: 1))
+        case 0xda, 0xc5: position += Int(try readUInt(size: 2))
+        case 0xdb, 0xc6: position += Int(try readUInt(size: 4))
+        case 0xd4...0xd8: position += 1 + (1 << Int(byte - 0xd4))
+        case 0xc7...0xc9: position += 1 + Int(try readUInt(size: 1 << Int(byte - 0xc7)))
+        case 0x90...0x9f, 0xdc, 0xdd:
+            position -= 1
+            let count = try decodeArrayCount()
+            for _ in 0..<count {
+                try skip()
+            }
+        case 0x80...0x8f, 0xde, 0xdf:
+            position -= 1
+            let count = try decodeMapCount()
+            for _ in 0..<count * 2 {
+                try skip()
+            }
+        default:
+            throw MessagePackError.invalidData
+        }
+        guard position <= bytes.count else {
+            throw MessagePackError.insufficientData
+        }
+    }
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import MessagePack
+
+// Encodes MessagePack straight into the destination buffer
+// (connection output, region memory) instead of a temporary array.
+public protocol MessagePackWriter: class {
+    func write(_ byte: UInt8)
+    func write(_ bytes: UnsafeBufferPointer<UInt8>)
+}
+
+extension MessagePackWriter {
+    func write(bigEndian value: UInt64, size: Int) {
+        var shift = (size - 1) * 8
+        while shift >= 0 {
+            write(UInt8(truncatingBitPattern: value >> UInt64(shift)))
+            shift -= 8
+        }
+    }
+
+    public func encodeNil() {
+        write(0xc0)
+    }
+
+    public func encode(_ value: Bool) {
+        write(value ? 0xc3 : 0xc2)
+    }
+
+    public func encode(_ value: Int) {
+        guard value < 0 else {
+            encode(UInt(value))
+            return
+        }
+        switch value {
+        case -32..<0:
+            write(UInt8(bitPattern: Int8(value)))
+        case Int(Int8.min)..<0:
+            write(0xd0)
+            write(bigEndian: UInt64(bitPattern: Int64(value)), size: 1)
+        case Int(Int16.min)..<0:
+            write(0xd1)
+            write(bigEndian: UInt64(bitPattern: Int64(value)), size: 2)
+        case Int(Int32.min)..<0:
+            write(0xd2)
+            write(bigEndian: UInt64(bitPattern: Int64(value)), size: 4)
+        default:
+            write(0xd3)
+            write(bigEndian: UInt64(bitPattern: Int64(value)), size: 8)
+        }
+    }
+
+    public func encode(_ value: UInt) {
+        switch value {
+        case 0...0x7f:
+            write(UInt8(value))
+        case 0x80...0xff:
+            write(0xcc)
+            write(UInt8(value))
+        case 0x100...0xffff:
+            write(0xcd)
+            write(bigEndian: UInt64(value), size: 2)
+        case 0x10000...0xffff_ffff:
+            write(0xce)
+            write(bigEndian: UInt64(value), size: 4)
+        default:
+            write(0xcf)
+            write(bigEndian: UInt64(value), size: 8)
+        }
+    }
+
+    public func encode(_ value: Float) {
+        write(0xca)
+        write(bigEndian: UInt64(value.bitPattern), size: 4)
+    }
+
+    public func encode(_ value: Double) {
+        write(0xcb)
+        write(bigEndian: value.bitPattern, size: 8)
+    }
+
+    public func encode(_ value: String) {
+        let count = value.utf8.count
+        switch count {
+        case 0...0x1f:
+            write(0xa0 | UInt8(count))
+        case 0x20...0xff:
+            write(0xd9)
+            write(UInt8(count))
+        case 0x100...0xffff:
+            write(0xda)
+            write(bigEndian: UInt64(count), size: 2)
+        default:
+            write(0xdb)
+            write(bigEndian: UInt64(count), size: 4)
+        }
+        value.withCString { pointer in
+            pointer.withMemoryRebound(to: UInt8.self, capacity: count) { bytes in
+                write(UnsafeBufferPointer(start: bytes, count: count))
+            }
+        }
+    }
+
+    public func encode(binary value: UnsafeBufferPointer<UInt8>) {
+        let count = value.count
+        switch count {
+        case 0...0xff:
+            write(0xc4)
+            write(UInt8(count))
+        case 0x100...0xffff:
+            write(0xc5)
+            write(bigEndian: UInt64(count), size: 2)
+        default:
+            write(0xc6)
+            write(bigEndian: UInt64(count), size: 4)
+        }
+        write(value)
+    }
+
+    public func encodeArrayCount(_ count: Int) {
+        switch count {
+        case 0...0x0f:
+            write(0x90 | UInt8(count))
+        case 0x10...0xffff:
+            write(0xdc)
+            write(bigEndian: UInt64(count), size: 2)
+        default:
+            write(0xdd)
+            write(bigEndian: UInt64(count), size: 4)
+        }
+    }
+
+    public func encodeMapCount(_ count: Int) {
+        switch count {
+        case 0...0x0f:
+            write(0x80 | UInt8(count))
+        case 0x10...0xffff:
+            write(0xde)
+            write(bigEndian: UInt64(count), size: 2)
+        default:
+            write(0xdf)
+            write(bigEndian: UInt64(count), size: 4)
+        }
+    }
+
+    public func encode(_ extended: MessagePack.Extended) {
+        let count = extended.data.count
+        switch count {
+        case 1: write(0xd4)
+        case 2: write(0xd5)
+        case 4: write(0xd6)
+        case 8: write(0xd7)
+        case 16: write(0xd8)
+        case 0...0xff:
+            write(0xc7)
+            write(UInt8(count))
+        case 0x100...0xffff:
+            write(0xc8)
+            write(bigEndian: UInt64(count), size: 2)
+        default:
+            write(0xc9)
+            write(bigEndian: UInt64(count), size: 4)
+        }
+        write(UInt8(bitPattern: extended.type))
+        extended.data.withUnsafeBufferPointer { write($0) }
+    }
+
+    public func encode(_ tuple: Tuple) {
+        encodeArrayCount(tuple.count)
+        for value in tuple {
+            encode(value)
+        }
+    }
+
+    public func encode(_ value: MessagePack) {
+        switch value {
+        case .nil: encodeNil()
+        case .bool(let value): encode(value)
+        case .int(let value): encode(value)
+        case .uint(let value): encode(value)
+        case .float(let value): encode(value)
+        case .double(let value): encode(value)
+        case .string(let value): encode(value)
+        case .binary(let value): value.withUnsafeBufferPointer { encode(binary: $0) }
+        case .array(let value): encode(value)
+        case .map(let value):
+            encodeMapCount(value.count)
+            for (key, value) in value {
+                encode(key)
+                encode(value)
+            }
+        case .extended(let value): encode(value)
+        }
+    }
+}
+
+public final class MessagePackBytes: MessagePackWriter {
+    public var bytes: [UInt8] = []
+
+    public init() {}
+
+    public func write(_ byte: UInt8) {
+        bytes.append(byte)
+    }
+
+    public func write(_ bytes: UnsafeBufferPointer<UInt8>) {
+        self.bytes.append(contentsOf: bytes)
+    }
+}
+
+// Counts the encoded size, used to allocate the exact amount up front
+public final class MessagePackCounter: MessagePackWriter {
+    public var count = 0
+
+    public init() {}
+
+    public func write(_ byte: UInt8) {
+        count += 1
+    }
+
+    public func write(_ bytes: UnsafeBufferPointer<UInt8>) {
+        count += bytes.count
+    }
+}
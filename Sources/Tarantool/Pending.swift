@@ -0,0 +1,33 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+// Result of a request that is already in flight.
+// Dropping it without get() lets the source discard the response.
+public final class Pending<T> {
+    let wait: (Void) throws -> T
+    let cancel: (Void) -> Void
+    var isDone = false
+
+    public init(wait: @escaping (Void) throws -> T, cancel: @escaping (Void) -> Void = {}) {
+        self.wait = wait
+        self.cancel = cancel
+    }
+
+    deinit {
+        if !isDone {
+            cancel()
+        }
+    }
+
+    public func get() throws -> T {
+        isDone = true
+        return try wait()
+    }
+}
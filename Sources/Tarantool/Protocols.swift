@@ -25,4 +25,18 @@ public protocol DataSource {
     func delete(spaceId: Int, keys: Tuple, indexId: Int) throws
     func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) throws
     func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) throws
+    // server schema version, if the source tracks it
+    var schemaId: Int? { get }
+}
+
+extension DataSource {
+    public var schemaId: Int? {
+        return nil
+    }
+}
+
+// Sources that can send a select before its result is needed,
+// e.g. to fetch the next page while the current one is consumed
+public protocol PrefetchingDataSource: DataSource {
+    func prefetch(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> Pending<[Tuple]>
 }
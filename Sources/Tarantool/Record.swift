@@ -0,0 +1,147 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import MessagePack
+
+public enum RecordFieldType {
+    case unsigned
+    case integer
+    case number
+    case string
+    case boolean
+    case binary
+    case array
+    case map
+    case any
+}
+
+public struct RecordField {
+    public let name: String
+    public let type: RecordFieldType
+
+    public init(_ name: String, _ type: RecordFieldType) {
+        self.name = name
+        self.type = type
+    }
+}
+
+// Struct mapped to a tuple by field position, in space format order.
+// Rows are decoded straight from the wire or box memory and written
+// straight into the output, no Tuple is built in between:
+//
+// struct User: TarantoolRecord {
+//     static let fields = [RecordField("id", .unsigned), RecordField("name", .string)]
+//     let id: Int
+//     let name: String
+//
+//     init(from fields: inout MessagePackReader) throws {
+//         id = try fields.decodeInt()
+//         name = try fields.decodeString()
+//     }
+//
+//     func encode(to writer: MessagePackWriter) {
+//         writer.encode(id)
+//         writer.encode(name)
+//     }
+// }
+public protocol TarantoolRecord {
+    static var fields: [RecordField] { get }
+    // reads exactly fields.count values
+    init(from fields: inout MessagePackReader) throws
+    // writes exactly fields.count values, the array header is written by the caller
+    func encode(to writer: MessagePackWriter)
+}
+
+extension MessagePackReader {
+    // extra trailing fields, e.g. added by a newer space format, are skipped
+    public mutating func decode<R: TarantoolRecord>(_ type: R.Type) throws -> R {
+        let count = try decodeArrayCount()
+        let expected = R.fields.count
+        guard count >= expected else {
+            throw TarantoolError.invalidTuple(message: "expected \(expected) fields, got \(count)")
+        }
+        let record = try R(from: &self)
+        for _ in expected..<count {
+            try skip()
+        }
+        return record
+    }
+}
+
+extension MessagePackWriter {
+    public func encode<R: TarantoolRecord>(record: R) {
+        encodeArrayCount(R.fields.count)
+        record.encode(to: self)
+    }
+}
+
+// Sources reading and writing records without going through Tuple
+public protocol RecordDataSource: DataSource {
+    func select<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> [R]
+    func get<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, keys: Tuple, indexId: Int) throws -> R?
+    func insert<R: TarantoolRecord>(spaceId: Int, record: R) throws
+    func replace<R: TarantoolRecord>(spaceId: Int, record: R) throws
+}
+
+// round trip through bytes for sources that only know tuples
+func decodeRecord<R: TarantoolRecord>(_ type: R.Type, from tuple: Tuple) throws -> R {
+    let bytes = MessagePackBytes()
+    bytes.encode(tuple)
+    return try bytes.bytes.withUnsafeBufferPointer { buffer -> R in
+        var reader = MessagePackReader(bytes: buffer)
+        return try reader.decode(type)
+    }
+}
+
+func encodeRecord<R: TarantoolRecord>(_ record: R) throws -> Tuple {
+    let bytes = MessagePackBytes()
+    bytes.encode(record: record)
+    return try bytes.bytes.withUnsafeBufferPointer { buffer -> Tuple in
+        var reader = MessagePackReader(bytes: buffer)
+        guard let tuple = Tuple(try reader.decode()) else {
+            throw TarantoolError.invalidTuple(message: "record is not an array")
+        }
+        return tuple
+    }
+}
+
+extension Space {
+    public func select<R: TarantoolRecord>(_ type: R.Type, _ iterator: Iterator, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = Int.max) throws -> [R] {
+        if let source = source as? RecordDataSource {
+            return try source.select(type, spaceId: id, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+        return try select(iterator, keys: keys, indexId: indexId, offset: offset, limit: limit).map { row in
+            try decodeRecord(type, from: row)
+        }
+    }
+
+    public func get<R: TarantoolRecord>(_ type: R.Type, _ keys: Tuple, indexId: Int = 0) throws -> R? {
+        if let source = source as? RecordDataSource {
+            return try source.get(type, spaceId: id, keys: keys, indexId: indexId)
+        }
+        return try get(keys, indexId: indexId).map { row in
+            try decodeRecord(type, from: row)
+        }
+    }
+
+    public func insert<R: TarantoolRecord>(_ record: R) throws {
+        if let source = source as? RecordDataSource {
+            return try source.insert(spaceId: id, record: record)
+        }
+        try insert(try encodeRecord(record))
+    }
+
+    public func replace<R: TarantoolRecord>(_ record: R) throws {
+        if let source = source as? RecordDataSource {
+            return try source.replace(spaceId: id, record: record)
+        }
+        try replace(try encodeRecord(record))
+    }
+}
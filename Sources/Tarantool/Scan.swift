@@ -0,0 +1,126 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+// Lazy scan over an index. Pages are requested by the last seen key
+// with .gt / .lt, so every page costs the same on the server.
+// With a PrefetchingDataSource the next page is requested as soon as
+// the current one arrives.
+// Rows sharing the last key of a page are skipped by .gt / .lt,
+// so keyFields must identify a row: the parts of a unique index,
+// or those of a non-unique one followed by the primary key parts.
+public final class ScanIterator: Sequence, IteratorProtocol {
+    let space: Space
+    let indexId: Int
+    let keyFields: [Int]
+    let pageSize: Int
+    let nextIterator: Iterator
+
+    var page: [Tuple] = []
+    var position = 0
+    var pending: Pending<[Tuple]>?
+    var isLastPage = false
+    // set once a page fails, the iteration ends there
+    public private(set) var error: Error?
+
+    init(space: Space, iterator: Iterator, keys: Tuple, indexId: Int, keyFields: [Int], pageSize: Int) throws {
+        switch iterator {
+        case .all, .ge, .gt: nextIterator = .gt
+        case .le, .lt: nextIterator = .lt
+        default: throw TarantoolError.invalidIterator
+        }
+        self.space = space
+        self.indexId = indexId
+        self.keyFields = keyFields
+        self.pageSize = pageSize
+
+        try request(iterator: iterator, keys: keys)
+        try receivePage()
+    }
+
+    func request(iterator: Iterator, keys: Tuple) throws {
+        if let source = space.source as? PrefetchingDataSource {
+            pending = try source.prefetch(spaceId: space.id, iterator: iterator, keys: keys, indexId: indexId, offset: 0, limit: pageSize)
+        } else {
+            let rows = try space.source.select(spaceId: space.id, iterator: iterator, keys: keys, indexId: indexId, offset: 0, limit: pageSize)
+            pending = Pending(wait: { rows })
+        }
+    }
+
+    func receivePage() throws {
+        guard let pending = pending else {
+            return
+        }
+        self.pending = nil
+        do {
+            page = try pending.get()
+        } catch {
+            self.error = error
+            page = []
+            position = 0
+            throw error
+        }
+        position = 0
+        isLastPage = page.count < pageSize
+
+        if !isLastPage, let last = page.last {
+            do {
+                try request(iterator: nextIterator, keys: try key(of: last))
+            } catch {
+                // thrown once this page is read
+                self.error = error
+            }
+        }
+    }
+
+    func key(of tuple: Tuple) throws -> Tuple {
+        return try keyFields.map { field in
+            guard field < tuple.count else {
+                throw TarantoolError.invalidTuple(message: "key field \(field) is missing")
+            }
+            return tuple[field]
+        }
+    }
+
+    public func nextTuple() throws -> Tuple? {
+        if position == page.count {
+            if let error = error {
+                throw error
+            }
+            guard !isLastPage else {
+                return nil
+            }
+            try receivePage()
+            guard page.count > 0 else {
+                return nil
+            }
+        }
+        let tuple = page[position]
+        position += 1
+        return tuple
+    }
+
+    // ends early if a page fails, check error afterwards
+    // or use nextTuple() to handle it in place
+    public func next() -> Tuple? {
+        do {
+            return try nextTuple()
+        } catch {
+            // kept in error
+            return nil
+        }
+    }
+}
+
+extension Space {
+    // keyFields are the tuple fields of the index parts, in order
+    public func scan(_ iterator: Iterator = .all, keys: Tuple = [], indexId: Int = 0, keyFields: [Int] = [0], pageSize: Int = 1000) throws -> ScanIterator {
+        return try ScanIterator(space: self, iterator: iterator, keys: keys, indexId: indexId, keyFields: keyFields, pageSize: pageSize)
+    }
+}
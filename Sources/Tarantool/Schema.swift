@@ -8,13 +8,33 @@
  * See CONTRIBUTORS.txt for the list of the project authors
  */
 
+import Foundation
+
 let _space: Int = 280
 let _vspace: Int = 281
+let _vindex: Int = 289
 
 public struct Schema: SchemaProtocol {
     public let spaces: [String: Space]
+    // schema version the snapshot was loaded at, nil if unknown
+    public let id: Int?
+
     public init(_ source: DataSource) throws {
         let tuples = try source.select(spaceId: _vspace, iterator: .all, keys: [], indexId: 0, offset: 0, limit: Int.max)
+        let indexTuples = try source.select(spaceId: _vindex, iterator: .all, keys: [], indexId: 0, offset: 0, limit: Int.max)
+
+        var indexes: [Int: [String: Int]] = [:]
+        for tuple in indexTuples {
+            guard
+                let spaceId = Int(tuple[0]),
+                let id = Int(tuple[1]),
+                let name = String(tuple[2]) else {
+                    throw TarantoolError.invalidSchema
+            }
+            var spaceIndexes = indexes[spaceId] ?? [:]
+            spaceIndexes[name] = id
+            indexes[spaceId] = spaceIndexes
+        }
 
         var spaces: [String: Space] = [:]
         for tuple in tuples {
@@ -23,8 +43,91 @@ public struct Schema: SchemaProtocol {
                 let name = String(tuple[2]) else {
                     throw TarantoolError.invalidSchema
             }
-            spaces[name] = Space(id: id, source: source)
+            spaces[name] = Space(id: id, name: name, indexes: indexes[id] ?? [:], source: source)
         }
         self.spaces = spaces
+        self.id = source.schemaId
+    }
+}
+
+// Schema shared between requests. Reloaded only when the source reports
+// a different schema version or a name is missing, so a lookup is a
+// dictionary hit instead of a _vspace scan. Keep one per source.
+// Sources without a schema id are never reloaded on ALTER: inside
+// tarantool use BoxDataSource.space(_:) instead.
+public final class SchemaCache {
+    let source: DataSource
+    let lock: Condition
+    var schema: Schema?
+    var isLoading = false
+
+    // FiberCondition inside tarantool, NSCondition for threads:
+    // callers wait on it while another one loads the schema
+    public init(source: DataSource, lock: Condition) {
+        self.source = source
+        self.lock = lock
+    }
+
+    // the lock is not held while loading, other callers park instead
+    public func get() throws -> Schema {
+        lock.lock()
+        defer { lock.unlock() }
+
+        while true {
+            if let schema = schema, schema.id == source.schemaId {
+                return schema
+            }
+            guard isLoading else {
+                break
+            }
+            lock.wait()
+        }
+
+        isLoading = true
+        lock.unlock()
+        let loaded: Schema
+        do {
+            loaded = try Schema(source)
+        } catch {
+            lock.lock()
+            isLoading = false
+            lock.broadcast()
+            throw error
+        }
+        lock.lock()
+        schema = loaded
+        isLoading = false
+        lock.broadcast()
+        return loaded
+    }
+
+    public func invalidate() {
+        lock.lock()
+        defer { lock.unlock() }
+        schema = nil
+    }
+
+    // Runs body with the cached schema. A request rejected for an outdated
+    // schema id invalidates the cache and body is run once more, so the
+    // ids it resolves come from the new schema.
+    public func perform<T>(_ body: (Schema) throws -> T) throws -> T {
+        do {
+            return try body(try get())
+        } catch TarantoolError.schemaChanged {
+            invalidate()
+            return try body(try get())
+        }
+    }
+
+    public func space(_ name: String) throws -> Space {
+        if let space = try get().spaces[name] {
+            return space
+        }
+        // created after the snapshot
+        invalidate()
+        guard let space = try get().spaces[name] else {
+            throw TarantoolError.spaceNotFound
+        }
+        return space
     }
 }
@@ -12,11 +12,22 @@ import Foundation
 
 public struct Space {
     public let id: Int
+    public let name: String
+    public let indexes: [String : Int]
     public let source: DataSource
 
-    public init(id: Int, source: DataSource) {
+    public init(id: Int, name: String = "", indexes: [String : Int] = [:], source: DataSource) {
         self.source = source
         self.id = id
+        self.name = name
+        self.indexes = indexes
+    }
+
+    public func indexId(_ name: String) throws -> Int {
+        guard let id = indexes[name] else {
+            throw TarantoolError.indexNotFound
+        }
+        return id
     }
 
     public func select(_ iterator: Iterator, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = Int.max) throws -> [Tuple] {
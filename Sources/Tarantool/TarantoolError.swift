@@ -13,5 +13,8 @@ public enum TarantoolError: Error {
     case indexNotFound
     case invalidSchema
     case invalidTuple(message: String)
+    case invalidIterator
     case notEnoughMemory
+    // request rejected, space / index ids must be resolved again
+    case schemaChanged
 }
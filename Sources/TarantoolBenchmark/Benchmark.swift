@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Dispatch
+
+enum BenchmarkError: Error {
+    case mockServer(String)
+}
+
+struct Benchmark {
+    let name: String
+    let iterations: Int
+    let operations: Int
+
+    init(name: String, iterations: Int, operations: Int = 1) {
+        self.name = name
+        self.iterations = iterations
+        self.operations = operations
+    }
+
+    // one JSON object per line, easy to diff between builds
+    func report(total: UInt64, samples: [UInt64]) {
+        let nsPerOp = Double(total) / Double(iterations * operations)
+        var line = "{\"name\":\"\(name)\",\"iterations\":\(iterations),\"ns_per_op\":\(Int(nsPerOp))"
+        if !samples.isEmpty {
+            let sorted = samples.sorted()
+            let p50 = sorted[sorted.count / 2]
+            let p99 = sorted[min(sorted.count - 1, sorted.count * 99 / 100)]
+            line += ",\"p50_ns\":\(p50),\"p99_ns\":\(p99)"
+        }
+        line += "}"
+        print(line)
+    }
+
+    // throughput only, no per-op clock reads
+    func run(_ body: (Void) throws -> Void) rethrows {
+        for _ in 0..<min(iterations / 10, 1000) {
+            try body()
+        }
+        let start = now()
+        for _ in 0..<iterations {
+            try body()
+        }
+        report(total: now() - start, samples: [])
+    }
+
+    // latency distribution of sequential calls
+    func measure(_ body: (Void) throws -> Void) rethrows {
+        for _ in 0..<min(iterations / 10, 1000) {
+            try body()
+        }
+        var samples = [UInt64]()
+        samples.reserveCapacity(iterations)
+        let start = now()
+        for _ in 0..<iterations {
+            let begin = now()
+            try body()
+            samples.append(now() - begin)
+        }
+        report(total: now() - start, samples: samples)
+    }
+
+    func now() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Dispatch
+import TarantoolConnector
+
+// Local IProto server replaying canned responses:
+// selects get `rows`, everything else gets an empty body.
+final class MockServer {
+    let descriptor: Int32
+    let port: UInt16
+    let rows: Tuple
+
+    init(rows: Tuple) throws {
+        self.rows = rows
+        #if os(Linux)
+        descriptor = socket(AF_INET, Int32(SOCK_STREAM.rawValue), 0)
+        #else
+        descriptor = socket(AF_INET, SOCK_STREAM, 0)
+        #endif
+        guard descriptor >= 0 else {
+            throw BenchmarkError.mockServer("socket")
+        }
+
+        var address = sockaddr_in()
+        address.sin_family = sa_family_t(AF_INET)
+        address.sin_addr.s_addr = UInt32(0x7f000001).bigEndian
+        address.sin_port = 0
+        var length = socklen_t(MemoryLayout<sockaddr_in>.size)
+
+        let bound = withUnsafePointer(to: &address) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                bind(descriptor, $0, length)
+            }
+        }
+        guard bound == 0, listen(descriptor, 128) == 0 else {
+            throw BenchmarkError.mockServer("bind")
+        }
+        _ = withUnsafeMutablePointer(to: &address) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                getsockname(descriptor, $0, &length)
+            }
+        }
+        port = UInt16(bigEndian: address.sin_port)
+    }
+
+    func start() {
+        DispatchQueue.global().async {
+            while true {
+                let client = accept(self.descriptor, nil, nil)
+                guard client >= 0 else {
+                    return
+                }
+                DispatchQueue.global().async {
+                    self.serve(client)
+                    close(client)
+                }
+            }
+        }
+    }
+
+    static var welcome: [UInt8] {
+        var greeting = [UInt8]("Tarantool 1.7.3 (Binary) 00000000-0000-0000-0000-000000000000".utf8)
+        greeting += [UInt8](repeating: 0x20, count: 63 - greeting.count) + [0x0a]
+        var salt = [UInt8]("U29tZSBzYWx0IGZvciB0aGUgYmVuY2htYXJrIHNlcnY=".utf8)
+        salt += [UInt8](repeating: 0x20, count: 63 - salt.count) + [0x0a]
+        return greeting + salt
+    }
+
+    func response(sync: Int, code: Int) -> [UInt8] {
+        let packet = MessagePackBytes()
+        packet.encodeMapCount(3)
+        packet.encode(Key.code.rawValue)
+        packet.encode(0)
+        packet.encode(Key.sync.rawValue)
+        packet.encode(sync)
+        packet.encode(Key.schemaId.rawValue)
+        packet.encode(1)
+        if code == Int(Code.select.rawValue) {
+            packet.encodeMapCount(1)
+            packet.encode(Key.data.rawValue)
+            packet.encode(rows)
+        } else {
+            packet.encodeMapCount(0)
+        }
+
+        let size = UInt32(packet.bytes.count)
+        return [0xce,
+            UInt8(truncatingBitPattern: size >> 24),
+            UInt8(truncatingBitPattern: size >> 16),
+            UInt8(truncatingBitPattern: size >> 8),
+            UInt8(truncatingBitPattern: size)] + packet.bytes
+    }
+
+    func serve(_ client: Int32) {
+        guard writeAll(client, MockServer.welcome) else {
+            return
+        }
+
+        var input = [UInt8]()
+        var chunk = [UInt8](repeating: 0, count: 64 * 1024)
+        while true {
+            let count = read(client, &chunk, chunk.count)
+            guard count > 0 else {
+                return
+            }
+            input += chunk[0..<count]
+
+            var output = [UInt8]()
+            var position = 0
+            while input.count - position >= 5 {
+                let length = Int(input[position+1]) << 24 | Int(input[position+2]) << 16
+                    | Int(input[position+3]) << 8 | Int(input[position+4])
+                guard input.count - position - 5 >= length else {
+                    break
+                }
+                let header: (code: Int, sync: Int)? = input.withUnsafeBufferPointer { bytes in
+                    let packet = UnsafeBufferPointer(start: bytes.baseAddress! + position + 5, count: length)
+                    var reader = MessagePackReader(bytes: packet)
+                    return try? MockServer.header(&reader)
+                }
+                guard let (code, sync) = header else {
+                    return
+                }
+                output += response(sync: sync, code: code)
+                position += 5 + length
+            }
+            input.removeFirst(position)
+
+            guard writeAll(client, output) else {
+                return
+            }
+        }
+    }
+
+    static func header(_ reader: inout MessagePackReader) throws -> (code: Int, sync: Int) {
+        var code = 0
+        var sync = 0
+        let count = try reader.decodeMapCount()
+        for _ in 0..<count {
+            switch try reader.decodeInt() {
+            case 0x00: code = try reader.decodeInt()
+            case 0x01: sync = try reader.decodeInt()
+            default: try reader.skip()
+            }
+        }
+        return (code, sync)
+    }
+
+    func writeAll(_ client: Int32, _ bytes: [UInt8]) -> Bool {
+        var written = 0
+        while written < bytes.count {
+            let count = bytes.withUnsafeBufferPointer {
+                write(client, $0.baseAddress! + written, bytes.count - written)
+            }
+            guard count > 0 else {
+                return false
+            }
+            written += count
+        }
+        return true
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import TarantoolConnector
+
+// Runs against TARANTOOL_HOST[:TARANTOOL_PORT] if set,
+// otherwise against a local mock replaying canned responses.
+//
+// TARANTOOL_USER / TARANTOOL_PASSWORD  credentials for auth
+// TARANTOOL_SPACE                      space id for select/replace (512)
+// BENCHMARK_ITERATIONS                 iterations per benchmark (100000)
+//
+// Box.unpackTuple / Box.returnTuple need a running tarantool
+// and are not covered here.
+
+let environment = ProcessInfo.processInfo.environment
+let iterations = Int(environment["BENCHMARK_ITERATIONS"] ?? "") ?? 100_000
+let spaceId = Int(environment["TARANTOOL_SPACE"] ?? "") ?? 512
+let username = environment["TARANTOOL_USER"]
+let password = environment["TARANTOOL_PASSWORD"] ?? ""
+
+let row: Tuple = [.int(42), .string("Answer to the Ultimate Question"), .double(3.14), .bool(true), .int(-1)]
+let rows: Tuple = [MessagePack](repeating: .array(row), count: 100)
+
+let host: String
+let port: UInt16
+if let remote = environment["TARANTOOL_HOST"] {
+    host = remote
+    port = UInt16(environment["TARANTOOL_PORT"] ?? "") ?? 3301
+} else {
+    let server = try MockServer(rows: rows)
+    server.start()
+    host = "127.0.0.1"
+    port = server.port
+}
+
+// encoding, through the connector's own packet encoder
+
+let encoder = RequestEncoder()
+
+try Benchmark(name: "encode.select", iterations: iterations).run {
+    encoder.reset()
+    try encoder.select(spaceId: spaceId, iterator: .eq, keys: [.int(42)])
+}
+
+try Benchmark(name: "encode.insert", iterations: iterations).run {
+    encoder.reset()
+    try encoder.insert(spaceId: spaceId, tuple: row)
+}
+
+try Benchmark(name: "encode.update", iterations: iterations).run {
+    encoder.reset()
+    try encoder.update(spaceId: spaceId, keys: [.int(42)], ops: [.array([.string("="), .int(1), .string("updated")])])
+}
+
+// decoding
+
+let bytes = MessagePackBytes()
+bytes.encodeMapCount(1)
+bytes.encode(Key.data.rawValue)
+bytes.encode(rows)
+let response = bytes.bytes
+
+try Benchmark(name: "decode.select.100rows", iterations: iterations / 10).run {
+    try response.withUnsafeBufferPointer { buffer in
+        var reader = MessagePackReader(bytes: buffer)
+        _ = try reader.decode()
+    }
+}
+
+// round-trips
+
+let connection = try IProtoConnection(host: host, port: port)
+if environment["TARANTOOL_HOST"] == nil || username != nil {
+    try Benchmark(name: "auth", iterations: iterations / 10).measure {
+        try connection.auth(username: username ?? "guest", password: password)
+    }
+}
+
+let source = IProtoDataSource(connection: connection)
+
+try Benchmark(name: "request.ping", iterations: iterations).measure {
+    try connection.ping()
+}
+
+try Benchmark(name: "request.get", iterations: iterations).measure {
+    _ = try source.get(spaceId: spaceId, keys: [.int(42)], indexId: 0)
+}
+
+try Benchmark(name: "request.select", iterations: iterations / 10).measure {
+    _ = try source.select(spaceId: spaceId, iterator: .all, keys: [], indexId: 0, offset: 0, limit: 100)
+}
+
+let prepared = PreparedSelect(spaceId: spaceId, indexId: 0, iterator: .eq)
+try Benchmark(name: "request.select.prepared", iterations: iterations).measure {
+    _ = try source.select(prepared, keys: [.int(42)], limit: 1)
+}
+
+try Benchmark(name: "request.replace", iterations: iterations).measure {
+    try source.replace(spaceId: spaceId, tuple: row)
+}
+
+// 100 requests in flight per batch
+let depth = 100
+try Benchmark(name: "request.get.pipelined", iterations: iterations / depth, operations: depth).run {
+    var pending: [Pending<[Tuple]>] = []
+    pending.reserveCapacity(depth)
+    for _ in 0..<depth {
+        pending.append(try source.prefetch(spaceId: spaceId, iterator: .eq, keys: [.int(42)], indexId: 0, offset: 0, limit: 1))
+    }
+    for request in pending {
+        _ = try request.get()
+    }
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+// Collects gets for the same index arriving within a short window
+// and resolves them with one call of a server-side multi-get function:
+//
+// function multiget(space_id, index_id, keys)
+//     local index = box.space[space_id].index[index_id]
+//     local rows = {}
+//     for i, key in ipairs(keys) do
+//         rows[i] = index:get(key) or box.NULL
+//     end
+//     return rows
+// end
+//
+// The function returns one array with a row or nil per key.
+// Everything except get is passed to the source.
+public final class BatchingDataSource: DataSource {
+    // gets / calls is the average batch size
+    public struct Statistics {
+        public let gets: Int
+        public let calls: Int
+    }
+
+    final class Batch {
+        var keys: [Tuple] = []
+        var rows: [Tuple?] = []
+        var error: Error?
+        var isDone = false
+        let deadline: Date
+
+        init(deadline: Date) {
+            self.deadline = deadline
+        }
+    }
+
+    struct BatchKey: Hashable {
+        let spaceId: Int
+        let indexId: Int
+
+        var hashValue: Int {
+            return spaceId &* 31 &+ indexId
+        }
+
+        static func ==(lhs: BatchKey, rhs: BatchKey) -> Bool {
+            return lhs.spaceId == rhs.spaceId && lhs.indexId == rhs.indexId
+        }
+    }
+
+    let source: DataSource
+    let call: (String, Tuple) throws -> Tuple
+    let function: String
+    let maxBatch: Int
+    let window: TimeInterval
+    let lock: Condition
+    var open: [BatchKey : Batch] = [:]
+    var calls = 0
+    var gets = 0
+
+    // window is how long the first get of a batch waits for company,
+    // lock is FiberCondition inside tarantool, NSCondition for threads
+    public init(
+        source: DataSource,
+        call: @escaping (String, Tuple) throws -> Tuple,
+        function: String = "multiget",
+        maxBatch: Int = 100,
+        window: TimeInterval = 0.001,
+        lock: Condition = NSCondition()
+    ) {
+        precondition(maxBatch > 0, "maxBatch must be positive")
+        self.source = source
+        self.call = call
+        self.function = function
+        self.maxBatch = maxBatch
+        self.window = window
+        self.lock = lock
+    }
+
+    public convenience init(source: IProtoDataSource, function: String = "multiget", maxBatch: Int = 100, window: TimeInterval = 0.001, lock: Condition = NSCondition()) {
+        let connection = source.connection
+        self.init(source: source, call: { function, arguments in
+            try connection.call(function, with: arguments)
+        }, function: function, maxBatch: maxBatch, window: window, lock: lock)
+    }
+
+    public convenience init(pool: IProtoPool, function: String = "multiget", maxBatch: Int = 100, window: TimeInterval = 0.001, lock: Condition = NSCondition()) {
+        self.init(source: pool, call: { function, arguments in
+            try pool.call(function, with: arguments)
+        }, function: function, maxBatch: maxBatch, window: window, lock: lock)
+    }
+
+    public var statistics: Statistics {
+        lock.lock()
+        defer { lock.unlock() }
+        return Statistics(gets: gets, calls: calls)
+    }
+
+    public var schemaId: Int? {
+        return source.schemaId
+    }
+
+    public func get(spaceId: Int, keys: Tuple, indexId: Int) throws -> Tuple? {
+        let key = BatchKey(spaceId: spaceId, indexId: indexId)
+
+        lock.lock()
+        gets += 1
+        if let batch = open[key] {
+            // joins the batch, its first caller sends it
+            let slot = batch.keys.count
+            batch.keys.append(keys)
+            if batch.keys.count >= maxBatch {
+                open.removeValue(forKey: key)
+                lock.broadcast()
+            }
+            while !batch.isDone {
+                lock.wait()
+            }
+            lock.unlock()
+            if let error = batch.error {
+                throw error
+            }
+            return batch.rows[slot]
+        }
+
+        let batch = Batch(deadline: Date(timeIntervalSinceNow: window))
+        batch.keys.append(keys)
+        open[key] = batch
+        // until the window closes or the batch is full
+        while open[key] === batch && batch.keys.count < maxBatch {
+            guard lock.wait(until: batch.deadline) else {
+                break
+            }
+        }
+        if open[key] === batch {
+            open.removeValue(forKey: key)
+        }
+        calls += 1
+        let batchKeys = batch.keys
+        lock.unlock()
+
+        var rows: [Tuple?] = []
+        var callError: Error?
+        do {
+            rows = try fetch(spaceId: spaceId, indexId: indexId, keys: batchKeys)
+        } catch {
+            callError = error
+        }
+
+        lock.lock()
+        batch.rows = rows
+        batch.error = callError
+        batch.isDone = true
+        lock.broadcast()
+        lock.unlock()
+
+        if let error = callError {
+            throw error
+        }
+        return rows[0]
+    }
+
+    func fetch(spaceId: Int, indexId: Int, keys: [Tuple]) throws -> [Tuple?] {
+        let arguments: Tuple = [.int(spaceId), .int(indexId), .array(keys.map { MessagePack.array($0) })]
+        let result = try call(function, arguments)
+        guard let first = result.first, let rows = Tuple(first), rows.count == keys.count else {
+            throw TarantoolError.invalidTuple(message: "\(function) must return one row or nil per key")
+        }
+        return rows.map { Tuple($0) }
+    }
+
+    public func select(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> [Tuple] {
+        return try source.select(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+    }
+
+    public func insert(spaceId: Int, tuple: Tuple) throws {
+        try source.insert(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func replace(spaceId: Int, tuple: Tuple) throws {
+        try source.replace(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func delete(spaceId: Int, keys: Tuple, indexId: Int) throws {
+        try source.delete(spaceId: spaceId, keys: keys, indexId: indexId)
+    }
+
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) throws {
+        try source.update(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+    }
+
+    public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) throws {
+        try source.upsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+    }
+}
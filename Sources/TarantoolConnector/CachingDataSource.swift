@@ -0,0 +1,282 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+// Read-through cache of get() results in front of another source.
+// Writes through this source drop every cached row of the space,
+// writes made elsewhere are only noticed when the TTL expires.
+public final class CachingDataSource: DataSource {
+    public struct Statistics {
+        public let hits: Int
+        public let misses: Int
+        public let evictions: Int
+    }
+
+    let source: DataSource
+    let shards: [CacheShard]
+    let ttl: TimeInterval
+
+    // capacity is split evenly between the shards,
+    // makeLock gives each shard its own lock, e.g. FiberCondition in tarantool
+    public init(
+        source: DataSource,
+        capacity: Int = 100_000,
+        shards: Int = 16,
+        ttl: TimeInterval = 60,
+        lock makeLock: (Void) -> Condition = { NSCondition() }
+    ) {
+        precondition(capacity > 0 && shards > 0, "capacity and shards must be positive")
+        let shardCapacity = max(capacity / shards, 1)
+        var list: [CacheShard] = []
+        for _ in 0..<shards {
+            list.append(CacheShard(capacity: shardCapacity, lock: makeLock()))
+        }
+        self.source = source
+        self.shards = list
+        self.ttl = ttl
+    }
+
+    public var statistics: Statistics {
+        var hits = 0, misses = 0, evictions = 0
+        for shard in shards {
+            shard.lock.lock()
+            hits += shard.hits
+            misses += shard.misses
+            evictions += shard.evictions
+            shard.lock.unlock()
+        }
+        return Statistics(hits: hits, misses: misses, evictions: evictions)
+    }
+
+    public var schemaId: Int? {
+        return source.schemaId
+    }
+
+    func shard(for key: CacheKey) -> CacheShard {
+        return shards[Int(key.hash % UInt(shards.count))]
+    }
+
+    public func get(spaceId: Int, keys: Tuple, indexId: Int) throws -> Tuple? {
+        let key = CacheKey(spaceId: spaceId, indexId: indexId, keys: keys)
+        let shard = self.shard(for: key)
+        let now = Date().timeIntervalSinceReferenceDate
+
+        shard.lock.lock()
+        let cached = shard.lookup(key, now: now)
+        let generation = shard.generation(of: spaceId)
+        shard.lock.unlock()
+
+        if let tuple = cached {
+            return tuple
+        }
+
+        let tuple = try source.get(spaceId: spaceId, keys: keys, indexId: indexId)
+        if let tuple = tuple {
+            shard.lock.lock()
+            // a write that happened meanwhile bumped the generation
+            if shard.generation(of: spaceId) == generation {
+                shard.store(key, tuple: tuple, generation: generation, expires: now + ttl)
+            }
+            shard.lock.unlock()
+        }
+        return tuple
+    }
+
+    public func invalidate(spaceId: Int) {
+        for shard in shards {
+            shard.lock.lock()
+            shard.invalidate(spaceId: spaceId)
+            shard.lock.unlock()
+        }
+    }
+
+    public func select(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> [Tuple] {
+        return try source.select(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+    }
+
+    // any index of the space may have cached the row, so all of it goes
+    public func insert(spaceId: Int, tuple: Tuple) throws {
+        defer { invalidate(spaceId: spaceId) }
+        try source.insert(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func replace(spaceId: Int, tuple: Tuple) throws {
+        defer { invalidate(spaceId: spaceId) }
+        try source.replace(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func delete(spaceId: Int, keys: Tuple, indexId: Int) throws {
+        defer { invalidate(spaceId: spaceId) }
+        try source.delete(spaceId: spaceId, keys: keys, indexId: indexId)
+    }
+
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) throws {
+        defer { invalidate(spaceId: spaceId) }
+        try source.update(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+    }
+
+    public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) throws {
+        defer { invalidate(spaceId: spaceId) }
+        try source.upsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+    }
+}
+
+// space, index and the msgpack encoded key
+struct CacheKey: Hashable {
+    let spaceId: Int
+    let indexId: Int
+    let bytes: [UInt8]
+    let hash: UInt
+
+    init(spaceId: Int, indexId: Int, keys: Tuple) {
+        let encoded = MessagePackBytes()
+        encoded.encode(keys)
+        self.spaceId = spaceId
+        self.indexId = indexId
+        self.bytes = encoded.bytes
+
+        var hash = FNV1a()
+        hash.combine(bytes)
+        hash.combine(spaceId)
+        hash.combine(indexId)
+        self.hash = hash.value
+    }
+
+    var hashValue: Int {
+        return Int(bitPattern: hash)
+    }
+
+    static func ==(lhs: CacheKey, rhs: CacheKey) -> Bool {
+        return lhs.hash == rhs.hash
+            && lhs.spaceId == rhs.spaceId
+            && lhs.indexId == rhs.indexId
+            && lhs.bytes == rhs.bytes
+    }
+}
+
+// LRU list threaded through an array by index, no node objects
+final class CacheShard {
+    struct Entry {
+        var key: CacheKey
+        var tuple: Tuple
+        var generation: Int
+        var expires: TimeInterval
+        var prev: Int
+        var next: Int
+    }
+
+    let capacity: Int
+    let lock: Condition
+
+    var entries: [Entry] = []
+    var positions: [CacheKey : Int] = [:]
+    // most and least recently used
+    var head = -1
+    var tail = -1
+    // bumped by writes, older entries are stale
+    var generations: [Int : Int] = [:]
+
+    var hits = 0
+    var misses = 0
+    var evictions = 0
+
+    init(capacity: Int, lock: Condition) {
+        self.capacity = capacity
+        self.lock = lock
+    }
+
+    func generation(of spaceId: Int) -> Int {
+        return generations[spaceId] ?? 0
+    }
+
+    func invalidate(spaceId: Int) {
+        generations[spaceId] = generation(of: spaceId) + 1
+    }
+
+    func lookup(_ key: CacheKey, now: TimeInterval) -> Tuple? {
+        guard let position = positions[key] else {
+            misses += 1
+            return nil
+        }
+        let entry = entries[position]
+        guard entry.expires > now, entry.generation == generation(of: key.spaceId) else {
+            // the slot is reused by the next store
+            misses += 1
+            return nil
+        }
+        hits += 1
+        moveToFront(position)
+        return entry.tuple
+    }
+
+    func store(_ key: CacheKey, tuple: Tuple, generation: Int, expires: TimeInterval) {
+        if let position = positions[key] {
+            entries[position].tuple = tuple
+            entries[position].generation = generation
+            entries[position].expires = expires
+            moveToFront(position)
+            return
+        }
+
+        let entry = Entry(key: key, tuple: tuple, generation: generation, expires: expires, prev: -1, next: -1)
+        let position: Int
+        if entries.count < capacity {
+            position = entries.count
+            entries.append(entry)
+        } else {
+            position = tail
+            unlink(position)
+            positions.removeValue(forKey: entries[position].key)
+            entries[position] = entry
+            evictions += 1
+        }
+        positions[key] = position
+        pushFront(position)
+    }
+
+    func moveToFront(_ position: Int) {
+        guard position != head else {
+            return
+        }
+        unlink(position)
+        pushFront(position)
+    }
+
+    func unlink(_ position: Int) {
+        let prev = entries[position].prev
+        let next = entries[position].next
+        if prev != -1 {
+            entries[prev].next = next
+        } else {
+            head = next
+        }
+        if next != -1 {
+            entries[next].prev = prev
+        } else {
+            tail = prev
+        }
+        entries[position].prev = -1
+        entries[position].next = -1
+    }
+
+    func pushFront(_ position: Int) {
+        entries[position].next = head
+        entries[position].prev = -1
+        if head != -1 {
+            entries[head].prev = position
+        }
+        head = position
+        if tail == -1 {
+            tail = position
+        }
+    }
+}
@@ -8,26 +8,76 @@
  * See CONTRIBUTORS.txt for the list of the project authors
  */
 
-import CryptoSwift
+typealias Digest = (
+    UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8,
+    UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8)
 
-// Use Array where Element == UInt8 when swift 3.1 is out
-extension Sequence where Iterator.Element == UInt8 {
-    func chapSha1(salt: [UInt8]) -> [UInt8] {
-        let scrambleSize = 20
-        let data: [UInt8] = self as! [UInt8]
+fileprivate let emptyDigest: Digest = (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
 
-        var step1 = [UInt8](repeating: 0, count: scrambleSize)
-        var step2 = [UInt8](repeating: 0, count: scrambleSize)
-        var step3 = [UInt8](repeating: 0, count: scrambleSize)
-        var scramble = [UInt8](repeating: 0, count: scrambleSize)
+fileprivate func withDigest<T>(_ digest: inout Digest, _ body: (UnsafeMutablePointer<UInt8>) throws -> T) rethrows -> T {
+    return try withUnsafeMutableBytes(of: &digest) { bytes in
+        try body(bytes.baseAddress!.assumingMemoryBound(to: UInt8.self))
+    }
+}
+
+// scramble = sha1(password) xor sha1(salt + sha1(sha1(password)))
+// Both password steps are computed once per credential,
+// only the salted step is left for every connection.
+public struct ChapSha1 {
+    static let scrambleSize = SHA1.digestSize
+
+    var step1 = emptyDigest
+    var step2 = emptyDigest
 
-        step1 = data.sha1()
-        step2 = step1.sha1()
-        step3 = (salt.prefix(upTo: scrambleSize) + step2).sha1()
+    public init(password: String) {
+        var step1 = emptyDigest
+        var step2 = emptyDigest
+        let password = [UInt8](password.utf8)
+
+        password.withUnsafeBufferPointer { password in
+            withDigest(&step1) { step1 in
+                SHA1.hash(password, into: step1)
+            }
+        }
+        var input = step1
+        withDigest(&input) { step1 in
+            withDigest(&step2) { step2 in
+                SHA1.hash(UnsafeBufferPointer(start: step1, count: ChapSha1.scrambleSize), into: step2)
+            }
+        }
+
+        self.step1 = step1
+        self.step2 = step2
+    }
+
+    // writes scrambleSize bytes, salt must have at least as many
+    func scramble(salt: UnsafeBufferPointer<UInt8>, into scramble: UnsafeMutablePointer<UInt8>) {
+        var sha1 = SHA1()
+        sha1.update(UnsafeBufferPointer(start: salt.baseAddress, count: ChapSha1.scrambleSize))
+        var step2 = self.step2
+        withDigest(&step2) { step2 in
+            sha1.update(UnsafeBufferPointer(start: step2, count: ChapSha1.scrambleSize))
+        }
+        // step3 goes straight to the output and is xored in place
+        sha1.finish(into: scramble)
+        var step1 = self.step1
+        withDigest(&step1) { step1 in
+            for i in 0..<ChapSha1.scrambleSize {
+                scramble[i] ^= step1[i]
+            }
+        }
+    }
 
-        for i in 0 ..< scrambleSize {
-            scramble[i] = step1[i] ^ step3[i]
+    // scramble for the welcome salt, base64 is decoded on the stack
+    func withScramble<T>(welcome: Welcome, _ body: (UnsafeBufferPointer<UInt8>) throws -> T) throws -> T {
+        var salt = emptyDigest
+        var scramble = emptyDigest
+        return try withDigest(&salt) { salt in
+            try welcome.decodeSalt(into: salt, count: ChapSha1.scrambleSize)
+            return try withDigest(&scramble) { scramble in
+                self.scramble(salt: UnsafeBufferPointer(start: salt, count: ChapSha1.scrambleSize), into: scramble)
+                return try body(UnsafeBufferPointer(start: scramble, count: ChapSha1.scrambleSize))
+            }
         }
-        return scramble
     }
 }
@@ -0,0 +1,25 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Socket
+import Foundation
+
+// Awaiter that can give up at a deadline, e.g. coio_wait with
+// the remaining time. Sockets without one are polled instead.
+public protocol DeadlineAwaiter: IOAwaiter {
+    // false if the deadline passed first
+    func wait(for descriptor: Int32, event: IOEvent, deadline: Date) throws -> Bool
+}
+
+// Failure of a single wait, e.g. an awaiter timeout or a cancelled
+// fiber: nothing was read, so only the waiting request fails.
+public protocol IOWaitError: Error {
+    var isTimeout: Bool { get }
+}
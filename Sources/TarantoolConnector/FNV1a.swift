@@ -0,0 +1,25 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+// hash of encoded request keys, arrays aren't Hashable yet
+struct FNV1a {
+    static let prime: UInt = 1099511628211
+    var value: UInt = 14695981039346656037
+
+    mutating func combine(_ bytes: [UInt8]) {
+        for byte in bytes {
+            value = (value ^ UInt(byte)) &* FNV1a.prime
+        }
+    }
+
+    mutating func combine(_ int: Int) {
+        value = (value ^ UInt(bitPattern: int)) &* FNV1a.prime
+    }
+}
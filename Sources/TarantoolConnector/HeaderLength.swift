@@ -11,14 +11,12 @@
 struct HeaderLength {
     let length: Int
 
-    var bytes: [UInt8] {
-        var bytes = [UInt8](repeating: 0, count: 5)
+    func write(to bytes: UnsafeMutablePointer<UInt8>) {
         bytes[0] = 0xce
         bytes[1] = UInt8(truncatingBitPattern: length >> 24)
         bytes[2] = UInt8(truncatingBitPattern: length >> 16)
         bytes[3] = UInt8(truncatingBitPattern: length >> 8)
         bytes[4] = UInt8(truncatingBitPattern: length)
-        return bytes
     }
 
     init(_ length: Int) throws {
@@ -28,13 +26,13 @@ struct HeaderLength {
         self.length = length
     }
 
-    init(bytes: [UInt8]) throws {
-        guard bytes[0] == 0xce else {
-            throw MessagePackError.invalidData
-        }
+    init(bytes: UnsafeBufferPointer<UInt8>) throws {
         guard bytes.count >= 5 else {
             throw MessagePackError.insufficientData
         }
+        guard bytes[0] == 0xce else {
+            throw MessagePackError.invalidData
+        }
 
         self.length = Int(bytes[1]) << 24 | Int(bytes[2]) << 16 | Int(bytes[3]) << 8 | Int(bytes[4])
     }
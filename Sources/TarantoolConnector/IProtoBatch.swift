@@ -0,0 +1,139 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+
+// Mixed list of writes sent back to back in one round-trip.
+// Every operation gets its own result, a failed one doesn't abort the rest.
+public final class IProtoBatch {
+    enum Operation {
+        case insert(spaceId: Int, tuple: Tuple)
+        case replace(spaceId: Int, tuple: Tuple)
+        case delete(spaceId: Int, keys: Tuple, indexId: Int)
+        case update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int)
+        case upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int)
+
+        var code: Code {
+            switch self {
+            case .insert: return .insert
+            case .replace: return .replace
+            case .delete: return .delete
+            case .update: return .update
+            case .upsert: return .upsert
+            }
+        }
+
+        func write(to body: OutputBuffer) {
+            switch self {
+            case let .insert(spaceId, tuple):
+                body.writeTuple(spaceId: spaceId, tuple: tuple)
+            case let .replace(spaceId, tuple):
+                body.writeTuple(spaceId: spaceId, tuple: tuple)
+            case let .delete(spaceId, keys, indexId):
+                body.writeDelete(spaceId: spaceId, keys: keys, indexId: indexId)
+            case let .update(spaceId, keys, ops, indexId):
+                body.writeUpdate(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+            case let .upsert(spaceId, tuple, ops, indexId):
+                body.writeUpsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+            }
+        }
+    }
+
+    public enum Result {
+        case success(Tuple)
+        case failure(Error)
+    }
+
+    var operations: [Operation] = []
+
+    public init() {}
+
+    public var count: Int {
+        return operations.count
+    }
+
+    @discardableResult
+    public func insert(spaceId: Int, tuple: Tuple) -> IProtoBatch {
+        operations.append(.insert(spaceId: spaceId, tuple: tuple))
+        return self
+    }
+
+    @discardableResult
+    public func replace(spaceId: Int, tuple: Tuple) -> IProtoBatch {
+        operations.append(.replace(spaceId: spaceId, tuple: tuple))
+        return self
+    }
+
+    @discardableResult
+    public func delete(spaceId: Int, keys: Tuple, indexId: Int = 0) -> IProtoBatch {
+        operations.append(.delete(spaceId: spaceId, keys: keys, indexId: indexId))
+        return self
+    }
+
+    @discardableResult
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int = 0) -> IProtoBatch {
+        operations.append(.update(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId))
+        return self
+    }
+
+    @discardableResult
+    public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int = 0) -> IProtoBatch {
+        operations.append(.upsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId))
+        return self
+    }
+}
+
+extension IProtoConnection {
+    // Requests are corked into the output buffer and leave with one write
+    // (more only if the batch outgrows flushThreshold), then responses
+    // are collected in order. Throws only if the batch couldn't be sent.
+    public func execute(_ batch: IProtoBatch, deadline: Date? = nil) throws -> [IProtoBatch.Result] {
+        let deadline = self.deadline(deadline)
+        var syncs: [Int] = []
+        syncs.reserveCapacity(batch.count)
+        do {
+            for operation in batch.operations {
+                syncs.append(try send(code: operation.code) { body in
+                    operation.write(to: body)
+                })
+            }
+            try flush()
+        } catch {
+            for sync in syncs {
+                discard(sync: sync)
+            }
+            throw error
+        }
+
+        return syncs.map { sync in
+            do {
+                return .success(try checkingSchema {
+                    try receive(sync: sync, deadline: deadline).unpack()
+                })
+            } catch {
+                return .failure(error)
+            }
+        }
+    }
+}
+
+extension IProtoDataSource {
+    public func execute(_ batch: IProtoBatch, deadline: Date? = nil) throws -> [IProtoBatch.Result] {
+        return try connection.execute(batch, deadline: deadline)
+    }
+}
+
+extension IProtoPool {
+    public func execute(_ batch: IProtoBatch, deadline: Date? = nil) throws -> [IProtoBatch.Result] {
+        return try perform { source in
+            try source.execute(batch, deadline: deadline)
+        }
+    }
+}
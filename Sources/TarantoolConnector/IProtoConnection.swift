@@ -18,9 +18,41 @@ public typealias Keys = [Key : MessagePack]
 
 public class IProtoConnection {
     let socket: Socket
+    let awaiter: IOAwaiter?
     let welcome: Welcome
 
-    public init(host: String, port: UInt16 = 3301, awaiter: IOAwaiter? = nil) throws {
+    // pipelining: many requests share the socket, the caller
+    // that currently reads it dispatches responses by sync
+    let condition: Condition
+    var lastSync = 0
+    var isReading = false
+    var isWriting = false
+    var responses: [Int : IProtoResponse] = [:]
+    var pending = 0
+    var abandoned: Set<Int> = []
+    var error: Error?
+    var isClosed = false
+
+    // schema version of the last response, sent with every request
+    var lastSchemaId: Int?
+    static let wrongSchemaVersion = 0x8000 | 0x6d
+
+    // owned by the current reader
+    let input = InputBuffer()
+    var needed = 0
+
+    // requests are corked until someone waits for a response
+    // or the buffer grows over the threshold
+    var output = OutputBuffer()
+    var spare = OutputBuffer()
+    public var flushThreshold = 64 * 1024
+
+    // seconds, applied to every request without an explicit deadline
+    public var timeout: TimeInterval?
+
+    public init(host: String, port: UInt16 = 3301, awaiter: IOAwaiter? = nil, condition: Condition = NSCondition()) throws {
+        self.condition = condition
+        self.awaiter = awaiter
         socket = try Socket(awaiter: awaiter)
         try socket.connect(to: host, port: port)
 
@@ -38,119 +70,464 @@ public class IProtoConnection {
         try? socket.close(silent: true)
     }
 
-    private func send(code: Code, keys: Keys = [:], sync: MessagePack? = nil, schemaId: MessagePack? = nil) throws {
-        // 2/3 - header - MP_MAP
-        var header: Map = [:]
-        header[Key.code.rawValue] = code.rawValue
-        if let sync = sync {
-            header[Key.sync.rawValue] = sync
+    public var outstandingRequests: Int {
+        condition.lock()
+        defer { condition.unlock() }
+        return pending
+    }
+
+    public var schemaId: Int? {
+        condition.lock()
+        defer { condition.unlock() }
+        return lastSchemaId
+    }
+
+    // the socket failed, all following requests will fail too
+    public var isBroken: Bool {
+        condition.lock()
+        defer { condition.unlock() }
+        return error != nil
+    }
+
+    // raw requests carry a schema id only if the caller gives one
+    private func send(code: Code, keys: Keys = [:], schemaId: MessagePack? = nil) throws -> Int {
+        return try send(code: code, schemaId: schemaId, stampsSchema: false) { output in
+            output.encodeMapCount(keys.count)
+            for (key, value) in keys {
+                output.encode(key.rawValue)
+                output.encode(value)
+            }
         }
-        if let schemaId = schemaId {
-            header[Key.schemaId.rawValue] = schemaId
+    }
+
+    // stampsSchema: requests with space / index ids are sent with
+    // the last seen schema id, so the server rejects them after an ALTER
+    func send(code: Code, schemaId: MessagePack? = nil, stampsSchema: Bool = true, body: (OutputBuffer) throws -> Void) throws -> Int {
+        return try send(header: { output in
+            output.encode(Key.code.rawValue)
+            output.encode(code.rawValue)
+        }, schemaId: schemaId, stampsSchema: stampsSchema, body: body)
+    }
+
+    func send(_ prepared: PreparedRequest, schemaId: MessagePack? = nil, body: (OutputBuffer) throws -> Void) throws -> Int {
+        return try send(header: { output in
+            output.write(prepared.header)
+        }, schemaId: schemaId, stampsSchema: true, body: { output in
+            output.write(prepared.body)
+            try body(output)
+        })
+    }
+
+    // header writes the code pair, body writes the whole body map
+    private func send(header: (OutputBuffer) -> Void, schemaId: MessagePack?, stampsSchema: Bool, body: (OutputBuffer) throws -> Void) throws -> Int {
+        condition.lock()
+        defer { condition.unlock() }
+
+        if let error = error {
+            throw error
         }
+        lastSync += 1
+        let sync = lastSync
 
-        // 3/3 - body - MP_MAP
-        var body: Map = [:]
-        for (key, value) in keys {
-            body[key.rawValue] = value
+        var schemaId = schemaId
+        if schemaId == nil && stampsSchema {
+            schemaId = lastSchemaId.map { MessagePack.int($0) }
         }
+        try output.writePacket(header: header, sync: sync, schemaId: schemaId, body: body)
 
-        var serializer = MPSerializer()
-        serializer.pack(header)
-        serializer.pack(body)
-        let packet = serializer.bytes
+        pending += 1
 
-        // 1/3 - header + body size
-        let size = try HeaderLength(packet.count).bytes
+        if output.count >= flushThreshold {
+            do {
+                try flushOutput()
+            } catch {
+                // the connection is broken, no response will come
+                pending -= 1
+                throw error
+            }
+        }
+        return sync
+    }
 
-        _ = try socket.write(bytes: size + packet)
+    // one-way packets like replication acks, the server doesn't answer
+    func post(code: Code, body: (OutputBuffer) throws -> Void) throws {
+        _ = try send(code: code, stampsSchema: false, body: body)
+        condition.lock()
+        defer { condition.unlock() }
+        pending -= 1
+        try flushOutput()
     }
 
-    private func receive() throws -> (header: MessagePack, body: MessagePack) {
-        let length = try readPacketLength()
+    // Writes everything queued so far with one syscall.
+    // Must be called with the condition locked, unlocks it while writing
+    // so other callers can keep queueing into the spare buffer.
+    private func flushOutput() throws {
+        while isWriting {
+            condition.wait()
+        }
+        if let error = error {
+            throw error
+        }
+        guard !output.isEmpty else {
+            return
+        }
 
-        var buffer = [UInt8](repeating: 0, count: length)
-        guard try socket.read(to: &buffer) == length else {
-            throw IProtoError.invalidPacket(reason: .invalidSize)
+        isWriting = true
+        let buffer = output
+        output = spare
+        spare = buffer
+        condition.unlock()
+
+        var writeError: Error?
+        do {
+            try buffer.write(to: socket)
+        } catch {
+            writeError = error
         }
 
-        var deserializer = MPDeserializer(bytes: buffer)
-        let header = try deserializer.unpack() as MessagePack
-        let body = try deserializer.unpack() as MessagePack
+        condition.lock()
+        isWriting = false
+        if let writeError = writeError {
+            self.error = writeError
+            condition.broadcast()
+            throw writeError
+        }
+        condition.broadcast()
+    }
 
-        return (header, body)
+    public func flush() throws {
+        condition.lock()
+        defer { condition.unlock() }
+        try flushOutput()
     }
 
-    private func readPacketLength() throws -> Int {
-        // always packed as 32bit integer CE XX XX XX XX
-        var lengthBuffer = [UInt8](repeating: 0, count: 5)
-        guard try socket.read(to: &lengthBuffer) == 5 else {
-            throw IProtoError.invalidPacket(reason: .invalidSize)
+    // A passed deadline or a cancelled caller fails only this request:
+    // the response is dropped on arrival, the connection stays usable.
+    func receive(sync: Int, deadline: Date? = nil) throws -> IProtoResponse {
+        condition.lock()
+        defer { condition.unlock() }
+
+        while true {
+            if let response = responses.removeValue(forKey: sync) {
+                pending -= 1
+                return response
+            }
+            do {
+                // nobody else will flush the request we are waiting for
+                try flushOutput()
+            } catch {
+                pending -= 1
+                throw error
+            }
+            if condition.isCancelled {
+                abandoned.insert(sync)
+                throw IProtoError.cancelled
+            }
+            if let deadline = deadline, deadline <= Date() {
+                abandoned.insert(sync)
+                throw IProtoError.timeout
+            }
+            // someone else is reading, wait for the dispatch
+            guard !isReading else {
+                if let deadline = deadline {
+                    _ = condition.wait(until: deadline)
+                } else {
+                    condition.wait()
+                }
+                continue
+            }
+
+            isReading = true
+            condition.unlock()
+
+            let response: IProtoResponse
+            do {
+                response = try readResponse(deadline: deadline)
+            } catch IProtoError.timeout {
+                // a partial packet stays in the input for the next reader
+                abandon(sync: sync)
+                throw IProtoError.timeout
+            } catch IProtoError.cancelled {
+                abandon(sync: sync)
+                throw IProtoError.cancelled
+            } catch {
+                condition.lock()
+                self.error = error
+                isReading = false
+                pending -= 1
+                condition.broadcast()
+                throw error
+            }
+
+            condition.lock()
+            isReading = false
+            dispatch(response)
+        }
+    }
+
+    // the leader gives up reading, the connection stays usable
+    private func abandon(sync: Int) {
+        condition.lock()
+        isReading = false
+        abandoned.insert(sync)
+        condition.broadcast()
+    }
+
+    // must be called with the condition locked
+    private func dispatch(_ response: IProtoResponse) {
+        if let schemaId = response.schemaId {
+            lastSchemaId = schemaId
+        }
+        if abandoned.remove(response.sync) != nil {
+            pending -= 1
+        } else {
+            responses[response.sync] = response
         }
-        return try HeaderLength(bytes: lengthBuffer).length
+        condition.broadcast()
     }
 
-    public func request(code: Code, keys: Keys = [:], sync: MessagePack? = nil, schemaId: MessagePack? = nil) throws -> Tuple {
-        try send(code: code, keys: keys, sync: sync, schemaId: schemaId)
-        let (header, body) = try receive()
+    // Hands the socket to a dedicated reader running in task, e.g. a fiber.
+    // Callers never read themselves anymore, they park on the condition
+    // until the reader dispatches their response. The reader keeps
+    // the connection alive until the socket fails or close() is called.
+    // If task fails to spawn the reader, callers read themselves again.
+    public func startReader(task: (@escaping (Void) -> Void) throws -> Void) rethrows {
+        condition.lock()
+        while isReading {
+            condition.wait()
+        }
+        isReading = true
+        condition.unlock()
 
-        //check header
-        guard let packedErrorCode = Map(header)?[0],
-            let errorCode = Int(packedErrorCode) else {
-            throw IProtoError.invalidPacket(reason: .invalidHeader)
+        do {
+            try task(readLoop)
+        } catch {
+            condition.lock()
+            isReading = false
+            condition.broadcast()
+            condition.unlock()
+            throw error
         }
-        guard errorCode < 0x8000 else {
-            //error packed as [0x31 : MP_STRING]
-            guard let errorMessage = body.map?[Key.error.rawValue], let description = String(errorMessage) else {
-                throw IProtoError.badRequest(code: errorCode, message: "nil")
+    }
+
+    private func readLoop() {
+        while true {
+            let response: IProtoResponse
+            do {
+                response = try readResponse()
+            } catch IProtoError.timeout {
+                // the awaiter's own timeout, idle connections are fine
+                continue
+            } catch {
+                condition.lock()
+                if self.error == nil {
+                    self.error = error
+                }
+                isReading = false
+                condition.broadcast()
+                condition.unlock()
+                return
             }
-            throw IProtoError.badRequest(code: errorCode, message: description)
+            condition.lock()
+            dispatch(response)
+            condition.unlock()
         }
+    }
 
+    // Fails all outstanding and following requests. A reader blocked
+    // in the socket is woken up by shutdown(2) and leaves before the fd
+    // is closed, so it never reads a descriptor reused by someone else.
+    public func close() {
+        condition.lock()
+        guard !isClosed else {
+            condition.unlock()
+            return
+        }
+        isClosed = true
+        if error == nil {
+            error = IProtoError.connectionClosed
+        }
+        condition.broadcast()
+        _ = shutdown(socket.descriptor, Int32(SHUT_RDWR))
+        while isReading {
+            condition.wait()
+        }
+        condition.unlock()
+        try? socket.close(silent: true)
+    }
+
+    // For streams like replication where the server keeps sending
+    // packets after one request: the caller owns the connection
+    // and takes the packets in order, nothing is dispatched by sync.
+    func readPacket() throws -> IProtoResponse {
+        condition.lock()
+        defer { condition.unlock() }
+        try flushOutput()
+        precondition(!isReading, "the stream is read by someone else")
+        isReading = true
+        condition.unlock()
+        defer {
+            condition.lock()
+            isReading = false
+            // close() may be waiting for the stream to leave the socket
+            condition.broadcast()
+        }
+        return try readResponse()
+    }
+
+    // the caller is not interested in the response anymore
+    func discard(sync: Int) {
+        condition.lock()
+        defer { condition.unlock() }
+        // nothing is read from a broken connection, don't wait for it
+        if responses.removeValue(forKey: sync) != nil || error != nil {
+            pending -= 1
+        } else {
+            abandoned.insert(sync)
+        }
+    }
+
+    private func readResponse(deadline: Date? = nil) throws -> IProtoResponse {
+        while true {
+            if let response = try parseResponse() {
+                return response
+            }
+            do {
+                if let deadline = deadline {
+                    guard try waitReadable(until: deadline) else {
+                        throw IProtoError.timeout
+                    }
+                }
+                try input.read(from: socket, size: max(InputBuffer.readSize, needed))
+            } catch let error as IOWaitError {
+                throw error.isTimeout ? IProtoError.timeout : IProtoError.cancelled
+            }
+        }
+    }
+
+    // false if nothing arrived before the deadline
+    private func waitReadable(until deadline: Date) throws -> Bool {
+        if let awaiter = awaiter as? DeadlineAwaiter {
+            return try awaiter.wait(for: socket.descriptor, event: .read, deadline: deadline)
+        }
+        var fd = pollfd(fd: socket.descriptor, events: Int16(POLLIN), revents: 0)
+        while true {
+            let timeout = deadline.timeIntervalSinceNow
+            guard timeout > 0 else {
+                return false
+            }
+            let milliseconds = Int32(min(ceil(timeout * 1000), Double(Int32.max)))
+            let result = poll(&fd, 1, milliseconds)
+            if result == -1 && errno == EINTR {
+                continue
+            }
+            // errors and hangups are reported by the read
+            return result != 0
+        }
+    }
+
+    // parses the next complete packet straight from the input buffer
+    private func parseResponse() throws -> IProtoResponse? {
+        // always packed as 32bit integer CE XX XX XX XX
+        guard input.count >= 5 else {
+            needed = 5
+            return nil
+        }
+        let length = try HeaderLength(bytes: input.bytes).length
+        guard input.count >= 5 + length else {
+            needed = 5 + length - input.count
+            return nil
+        }
+
+        let packet = UnsafeBufferPointer(start: input.bytes.baseAddress! + 5, count: length)
+        defer { input.consume(5 + length) }
+
+        var reader = MessagePackReader(bytes: packet)
+        return try IProtoResponse(from: &reader)
+    }
+
+    public func request(code: Code, keys: Keys = [:], schemaId: MessagePack? = nil, deadline: Date? = nil) throws -> Tuple {
+        return try roundTrip(deadline: deadline) {
+            try send(code: code, keys: keys, schemaId: schemaId)
+        }
+    }
+
+    func request(code: Code, deadline: Date? = nil, stampsSchema: Bool = true, body: (OutputBuffer) throws -> Void) throws -> Tuple {
+        return try roundTrip(deadline: deadline) {
+            try send(code: code, stampsSchema: stampsSchema, body: body)
+        }
+    }
+
+    func request(_ prepared: PreparedRequest, deadline: Date? = nil, body: (OutputBuffer) throws -> Void) throws -> Tuple {
+        return try roundTrip(deadline: deadline) {
+            try send(prepared, body: body)
+        }
+    }
+
+    // deadline for requests made without an explicit one
+    func deadline(_ deadline: Date?) -> Date? {
+        if let deadline = deadline {
+            return deadline
+        }
+        return timeout.map { Date(timeIntervalSinceNow: $0) }
+    }
 
-        guard let response = Map(body) else {
-            throw IProtoError.invalidPacket(reason: .invalidBody)
+    // A request carrying an outdated schema id is rejected by the server.
+    // Its space / index ids may be stale, so it is not repeated here:
+    // the caller re-resolves them, see SchemaCache.perform
+    func roundTrip(deadline: Date? = nil, _ send: (Void) throws -> Int) throws -> Tuple {
+        return try roundTrip(deadline: deadline, send) { response in
+            try response.unpack()
         }
+    }
 
-        //empty body e.g. ping response
-        guard response.count != 0 else {
-            return []
+    func roundTrip<T>(deadline: Date? = nil, _ send: (Void) throws -> Int, unpack: (IProtoResponse) throws -> T) throws -> T {
+        let deadline = self.deadline(deadline)
+        return try checkingSchema {
+            try unpack(try receive(sync: try send(), deadline: deadline))
         }
+    }
 
-        //body packed as [0x30 : MP_MAP]
-        guard let data = response[Key.data.rawValue], let tuple = Tuple(data) else {
-            throw IProtoError.invalidPacket(reason: .invalidBody)
+    // for paths receiving a stamped request themselves, like prefetch
+    func checkingSchema<T>(_ body: (Void) throws -> T) throws -> T {
+        do {
+            return try body()
+        } catch IProtoError.badRequest(let code, _) where code == IProtoConnection.wrongSchemaVersion {
+            throw TarantoolError.schemaChanged
         }
-        return tuple
     }
 }
 
 extension IProtoConnection {
     @discardableResult
-    public func ping() throws {
-        _ = try request(code: .ping)
+    public func ping(deadline: Date? = nil) throws {
+        _ = try request(code: .ping, deadline: deadline)
     }
 
-    public func call(_ function: String, with tuple: Tuple = []) throws -> Tuple {
-        return try request(code: .call, keys: [.functionName: .string(function), .tuple: .array(tuple)])
+    public func call(_ function: String, with tuple: Tuple = [], deadline: Date? = nil) throws -> Tuple {
+        return try request(code: .call, keys: [.functionName: .string(function), .tuple: .array(tuple)], deadline: deadline)
     }
 
-    public func eval(_ expression: String, with tuple: Tuple = []) throws -> Tuple {
-        return try request(code: .call, keys: [.functionName: .string(expression), .tuple: .array(tuple)])
+    public func eval(_ expression: String, with tuple: Tuple = [], deadline: Date? = nil) throws -> Tuple {
+        return try request(code: .call, keys: [.functionName: .string(expression), .tuple: .array(tuple)], deadline: deadline)
     }
 
     public func auth(username: String, password: String) throws {
-        let data = [UInt8](password.utf8)
-        guard let salt = Data(base64Encoded: welcome.salt) else {
-            throw IProtoError.invalidSalt
-        }
-
-        let scramble = data.chapSha1(salt: [UInt8](salt))
+        try auth(username: username, chapSha1: ChapSha1(password: password))
+    }
 
-        let keys: Keys = [
-            .username: .string(username),
-            .tuple: .array([.string("chap-sha1"), .binary(scramble)])
-        ]
-        _ = try request(code: .auth, keys: keys)
+    // reuse one ChapSha1 per credential, only the salted step runs here
+    public func auth(username: String, chapSha1: ChapSha1) throws {
+        _ = try chapSha1.withScramble(welcome: welcome) { scramble in
+            try request(code: .auth, stampsSchema: false) { body in
+                body.encodeMapCount(2)
+                body.encode(Key.username.rawValue)
+                body.encode(username)
+                body.encode(Key.tuple.rawValue)
+                body.encodeArrayCount(2)
+                body.encode("chap-sha1")
+                body.encode(binary: scramble)
+            }
+        }
     }
 }
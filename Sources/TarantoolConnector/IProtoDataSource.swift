@@ -18,73 +18,80 @@ public struct IProtoDataSource: DataSource {
         self.connection = connection
     }
 
-    public func select(spaceId: Int, iterator: Iterator = .eq, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws -> [Tuple] {
-        let result = try connection.request(code: .select, keys: [
-            .spaceId:  .int(spaceId),
-            .indexId:  .int(indexId),
-            .limit:    .int(limit),
-            .offset:   .int(offset),
-            .iterator: .int(iterator.rawValue),
-            .key:      .array(keys)]
-        )
+    public var schemaId: Int? {
+        return connection.schemaId
+    }
 
-        var rows: [Tuple] = []
-        for tuple in Tuple(result) {
-            rows.append(Tuple(tuple)!)
+    public func select(spaceId: Int, iterator: Iterator = .eq, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws -> [Tuple] {
+        let result = try connection.request(code: .select) { body in
+            body.writeSelect(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
         }
-        return rows
+        return try unpackRows(result)
     }
 
     public func get(spaceId: Int, keys: Tuple, indexId: Int) throws -> Tuple? {
-        let result = try connection.request(code: .select, keys: [
-            .spaceId:  .int(spaceId),
-            .indexId:  .int(indexId),
-            .limit:    .int(1),
-            .offset:   .int(0),
-            .iterator: .int(Iterator.eq.rawValue),
-            .key:      .array(keys)]
-        )
+        let result = try connection.request(code: .select) { body in
+            body.writeSelect(spaceId: spaceId, iterator: .eq, keys: keys, indexId: indexId, offset: 0, limit: 1)
+        }
 
-        return Tuple(Tuple(result).first)
+        return Tuple(result.first)
     }
 
     public func insert(spaceId: Int, tuple: Tuple) throws {
-        _ = try connection.request(code: .insert, keys: [
-            .spaceId: .int(spaceId),
-            .tuple: .array(tuple)]
-        )
+        _ = try connection.request(code: .insert) { body in
+            body.writeTuple(spaceId: spaceId, tuple: tuple)
+        }
     }
 
     public func replace(spaceId: Int, tuple: Tuple) throws {
-        _ = try connection.request(code: .replace, keys: [
-            .spaceId: .int(spaceId),
-            .tuple: .array(tuple)]
-        )
+        _ = try connection.request(code: .replace) { body in
+            body.writeTuple(spaceId: spaceId, tuple: tuple)
+        }
     }
 
     public func delete(spaceId: Int, keys: Tuple, indexId: Int = 0) throws {
-        _ = try connection.request(code: .delete, keys: [
-            .spaceId: .int(spaceId),
-            .indexId: .int(indexId),
-            .key: .array(keys)]
-        )
+        _ = try connection.request(code: .delete) { body in
+            body.writeDelete(spaceId: spaceId, keys: keys, indexId: indexId)
+        }
     }
 
     public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int = 0) throws {
-        _ = try connection.request(code: .update, keys: [
-            .spaceId: .int(spaceId),
-            .indexId: .int(indexId),
-            .key:     .array(keys),
-            .ops:     .array(ops)]
-        )
+        _ = try connection.request(code: .update) { body in
+            body.writeUpdate(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+        }
     }
 
     public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int = 0) throws {
-        _ = try connection.request(code: .upsert, keys: [
-            .spaceId: .int(spaceId),
-            .indexId: .int(indexId),
-            .tuple:   .array(tuple),
-            .ops:     .array(ops)]
-        )
+        _ = try connection.request(code: .upsert) { body in
+            body.writeUpsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+        }
+    }
+
+    public func select(_ prepared: PreparedSelect, keys: Tuple = [], offset: Int = 0, limit: Int = 1000) throws -> [Tuple] {
+        return try connection.select(prepared, keys: keys, offset: offset, limit: limit)
+    }
+}
+
+extension IProtoDataSource: PrefetchingDataSource {
+    public func prefetch(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> Pending<[Tuple]> {
+        let connection = self.connection
+        let deadline = connection.deadline(nil)
+        let sync = try connection.send(code: .select) { body in
+            body.writeSelect(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+        // uncork now, the page must be on its way while the caller works
+        do {
+            try connection.flush()
+        } catch {
+            connection.discard(sync: sync)
+            throw error
+        }
+        return Pending(wait: {
+            try connection.checkingSchema {
+                try unpackRows(try connection.receive(sync: sync, deadline: deadline).unpack())
+            }
+        }, cancel: {
+            connection.discard(sync: sync)
+        })
     }
 }
@@ -13,6 +13,9 @@ public enum IProtoError: Error {
     case invalidSalt
     case invalidPacket(reason: IProtoPacketError)
     case badRequest(code: Int, message: String)
+    case connectionClosed
+    case timeout
+    case cancelled
 }
 
 public enum IProtoPacketError {
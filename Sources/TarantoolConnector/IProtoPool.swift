@@ -0,0 +1,280 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Dispatch
+
+// DataSource over several connections to one or more instances.
+// Every call goes to the connection with the fewest outstanding requests,
+// broken connections are replaced in the background.
+public final class IProtoPool: DataSource {
+    public struct Endpoint {
+        public let host: String
+        public let port: UInt16
+
+        public init(host: String, port: UInt16 = 3301) {
+            self.host = host
+            self.port = port
+        }
+    }
+
+    public struct Credentials {
+        public let username: String
+        public let password: String
+        // password steps are hashed once for all reconnects
+        let chapSha1: ChapSha1
+
+        public init(username: String, password: String) {
+            self.username = username
+            self.password = password
+            self.chapSha1 = ChapSha1(password: password)
+        }
+    }
+
+    final class Member {
+        let endpoint: Endpoint
+        var connection: IProtoConnection?
+        var isReconnecting = false
+        var lastAttempt = Date.distantPast
+
+        init(endpoint: Endpoint) {
+            self.endpoint = endpoint
+        }
+    }
+
+    let members: [Member]
+    let credentials: Credentials?
+    let awaiter: IOAwaiter?
+    let makeCondition: (Void) -> Condition
+    let task: (@escaping (Void) -> Void) -> Void
+    let lock: Condition
+
+    public var retryInterval: TimeInterval = 1
+
+    // default request timeout of every member connection
+    public var timeout: TimeInterval? {
+        didSet {
+            lock.lock()
+            let connections = members.flatMap { $0.connection }
+            lock.unlock()
+            for connection in connections {
+                connection.timeout = timeout
+            }
+        }
+    }
+
+    // task runs reconnects in the background: a thread by default,
+    // pass AsyncTarantool's fiber to reconnect inside tarantool
+    public init(
+        endpoints: [Endpoint],
+        connectionsPerEndpoint: Int = 1,
+        credentials: Credentials? = nil,
+        awaiter: IOAwaiter? = nil,
+        condition makeCondition: @escaping (Void) -> Condition = { NSCondition() },
+        task: @escaping (@escaping (Void) -> Void) -> Void = { DispatchQueue.global().async(execute: $0) }
+    ) throws {
+        var members: [Member] = []
+        for endpoint in endpoints {
+            for _ in 0..<connectionsPerEndpoint {
+                members.append(Member(endpoint: endpoint))
+            }
+        }
+        self.members = members
+        self.credentials = credentials
+        self.awaiter = awaiter
+        self.makeCondition = makeCondition
+        self.task = task
+        self.lock = makeCondition()
+
+        // at least one member must be up, the rest will catch up
+        var lastError: Error?
+        for member in members {
+            do {
+                member.connection = try connect(to: member.endpoint)
+            } catch {
+                lastError = error
+                scheduleReconnect(member)
+            }
+        }
+        if let error = lastError, !members.contains(where: { $0.connection != nil }) {
+            throw error
+        }
+    }
+
+    // replicas have their own versions, any change shows up in the max
+    public var schemaId: Int? {
+        var schemaId: Int?
+        for member in members {
+            lock.lock()
+            let connection = member.connection
+            lock.unlock()
+            if let id = connection?.schemaId, id > schemaId ?? Int.min {
+                schemaId = id
+            }
+        }
+        return schemaId
+    }
+
+    func connect(to endpoint: Endpoint) throws -> IProtoConnection {
+        let connection = try IProtoConnection(
+            host: endpoint.host,
+            port: endpoint.port,
+            awaiter: awaiter,
+            condition: makeCondition())
+        connection.timeout = timeout
+        // every connection has its own welcome salt
+        if let credentials = credentials {
+            try connection.auth(username: credentials.username, chapSha1: credentials.chapSha1)
+        }
+        return connection
+    }
+
+    func scheduleReconnect(_ member: Member) {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !member.isReconnecting,
+            Date().timeIntervalSince(member.lastAttempt) >= retryInterval else {
+                return
+        }
+        member.isReconnecting = true
+        member.lastAttempt = Date()
+
+        task { [weak self] in
+            guard let pool = self else {
+                return
+            }
+            let connection = try? pool.connect(to: member.endpoint)
+
+            pool.lock.lock()
+            defer { pool.lock.unlock() }
+            if let connection = connection {
+                member.connection = connection
+            }
+            member.isReconnecting = false
+        }
+    }
+
+    func next(excluding excluded: IProtoConnection? = nil) throws -> IProtoConnection {
+        var best: IProtoConnection?
+        var bestLoad = Int.max
+        for member in members {
+            lock.lock()
+            let connection = member.connection
+            lock.unlock()
+
+            guard let candidate = connection, !candidate.isBroken else {
+                scheduleReconnect(member)
+                continue
+            }
+            guard candidate !== excluded else {
+                continue
+            }
+            let load = candidate.outstandingRequests
+            if load < bestLoad {
+                best = candidate
+                bestLoad = load
+            }
+        }
+        guard let connection = best else {
+            throw IProtoError.connectionClosed
+        }
+        return connection
+    }
+
+    func perform<T>(retry: Bool = false, _ body: (IProtoDataSource) throws -> T) throws -> T {
+        let connection = try next()
+        do {
+            return try body(IProtoDataSource(connection: connection))
+        } catch {
+            guard connection.isBroken else {
+                throw error
+            }
+            markBroken(connection)
+            // reads are safe to repeat on another member
+            guard retry else {
+                throw error
+            }
+            return try body(IProtoDataSource(connection: try next(excluding: connection)))
+        }
+    }
+
+    func markBroken(_ connection: IProtoConnection) {
+        for member in members {
+            lock.lock()
+            let isBroken = member.connection === connection
+            if isBroken {
+                member.connection = nil
+            }
+            lock.unlock()
+
+            if isBroken {
+                scheduleReconnect(member)
+            }
+        }
+    }
+
+    public func select(spaceId: Int, iterator: Iterator = .eq, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws -> [Tuple] {
+        return try perform(retry: true) { source in
+            try source.select(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+
+    public func get(spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> Tuple? {
+        return try perform(retry: true) { source in
+            try source.get(spaceId: spaceId, keys: keys, indexId: indexId)
+        }
+    }
+
+    public func insert(spaceId: Int, tuple: Tuple) throws {
+        try perform { source in
+            try source.insert(spaceId: spaceId, tuple: tuple)
+        }
+    }
+
+    public func replace(spaceId: Int, tuple: Tuple) throws {
+        try perform { source in
+            try source.replace(spaceId: spaceId, tuple: tuple)
+        }
+    }
+
+    public func delete(spaceId: Int, keys: Tuple, indexId: Int = 0) throws {
+        try perform { source in
+            try source.delete(spaceId: spaceId, keys: keys, indexId: indexId)
+        }
+    }
+
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int = 0) throws {
+        try perform { source in
+            try source.update(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+        }
+    }
+
+    public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int = 0) throws {
+        try perform { source in
+            try source.upsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+        }
+    }
+
+    // not retried, the function may have side effects
+    public func call(_ function: String, with tuple: Tuple = [], deadline: Date? = nil) throws -> Tuple {
+        return try perform { source in
+            try source.connection.call(function, with: tuple, deadline: deadline)
+        }
+    }
+}
+
+extension IProtoPool: PrefetchingDataSource {
+    public func prefetch(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> Pending<[Tuple]> {
+        return try perform { source in
+            try source.prefetch(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+}
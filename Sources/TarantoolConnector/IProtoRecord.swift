@@ -0,0 +1,86 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+extension IProtoConnection {
+    // rows go from the response bytes straight into records
+    func select<R: TarantoolRecord>(_ type: R.Type, deadline: Date? = nil, body: (OutputBuffer) throws -> Void) throws -> [R] {
+        return try roundTrip(deadline: deadline, {
+            try send(code: .select, body: body)
+        }, unpack: { response in
+            try response.unpackRecords(type)
+        })
+    }
+
+    // the stored tuple echoed back is skipped, not decoded
+    func write(code: Code, deadline: Date? = nil, body: (OutputBuffer) throws -> Void) throws {
+        try roundTrip(deadline: deadline, {
+            try send(code: code, body: body)
+        }, unpack: { response in
+            _ = try response.unpackData { data in
+                try data.skip()
+            }
+        })
+    }
+}
+
+extension IProtoDataSource: RecordDataSource {
+    public func select<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, iterator: Iterator = .eq, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws -> [R] {
+        return try connection.select(type) { body in
+            body.writeSelect(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+
+    public func get<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> R? {
+        return try connection.select(type) { body in
+            body.writeSelect(spaceId: spaceId, iterator: .eq, keys: keys, indexId: indexId, offset: 0, limit: 1)
+        }.first
+    }
+
+    public func insert<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try connection.write(code: .insert) { body in
+            body.writeRecord(spaceId: spaceId, record: record)
+        }
+    }
+
+    public func replace<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try connection.write(code: .replace) { body in
+            body.writeRecord(spaceId: spaceId, record: record)
+        }
+    }
+}
+
+extension IProtoPool: RecordDataSource {
+    public func select<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, iterator: Iterator = .eq, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws -> [R] {
+        return try perform(retry: true) { source in
+            try source.select(type, spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+
+    public func get<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> R? {
+        return try perform(retry: true) { source in
+            try source.get(type, spaceId: spaceId, keys: keys, indexId: indexId)
+        }
+    }
+
+    public func insert<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try perform { source in
+            try source.insert(spaceId: spaceId, record: record)
+        }
+    }
+
+    public func replace<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try perform { source in
+            try source.replace(spaceId: spaceId, record: record)
+        }
+    }
+}
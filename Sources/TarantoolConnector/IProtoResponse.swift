@@ -0,0 +1,135 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+struct IProtoResponse {
+    let code: Int
+    let sync: Int
+    let schemaId: Int?
+    // replication rows only
+    let serverId: Int?
+    let lsn: Int?
+    let timestamp: Double?
+    // Raw body, decoded by the caller waiting for the response.
+    // This is the one copy a response costs: the header is parsed in
+    // place, but the body outlives the input buffer's next read, which
+    // may move or reuse the bytes while the response waits for its caller.
+    let body: [UInt8]
+
+    // header is a map of small integers, decoded without building a Map
+    init(from reader: inout MessagePackReader) throws {
+        var code: Int?
+        var sync: Int?
+        var schemaId: Int?
+        var serverId: Int?
+        var lsn: Int?
+        var timestamp: Double?
+        let count = try reader.decodeMapCount()
+        for _ in 0..<count {
+            switch try reader.decodeInt() {
+            case 0x00: code = try reader.decodeInt()
+            case 0x01: sync = try reader.decodeInt()
+            case 0x02: serverId = try reader.decodeInt()
+            case 0x03: lsn = try reader.decodeInt()
+            case 0x04: timestamp = try reader.decodeDouble()
+            case 0x05: schemaId = try reader.decodeInt()
+            default: try reader.skip()
+            }
+        }
+        guard let headerCode = code, let headerSync = sync else {
+            throw IProtoError.invalidPacket(reason: .invalidHeader)
+        }
+        self.code = headerCode
+        self.sync = headerSync
+        self.schemaId = schemaId
+        self.serverId = serverId
+        self.lsn = lsn
+        self.timestamp = timestamp
+        // copied, see body
+        self.body = [UInt8](reader.remaining)
+    }
+
+    func unpack() throws -> Tuple {
+        let tuple = try unpackData { data -> Tuple in
+            guard let tuple = Tuple(try data.decode()) else {
+                throw IProtoError.invalidPacket(reason: .invalidBody)
+            }
+            return tuple
+        }
+        return tuple ?? []
+    }
+
+    // rows are decoded straight from the body bytes
+    func unpackRecords<R: TarantoolRecord>(_ type: R.Type) throws -> [R] {
+        let records = try unpackData { data -> [R] in
+            let count = try data.decodeArrayCount()
+            var records: [R] = []
+            records.reserveCapacity(count)
+            for _ in 0..<count {
+                records.append(try data.decode(type))
+            }
+            return records
+        }
+        return records ?? []
+    }
+
+    // calls read with the reader positioned at the data value,
+    // nil for an empty body e.g. ping response
+    func unpackData<T>(_ read: (inout MessagePackReader) throws -> T) throws -> T? {
+        return try body.withUnsafeBufferPointer { bytes -> T? in
+            var reader = MessagePackReader(bytes: bytes)
+            guard code < 0x8000 else {
+                throw IProtoError.badRequest(code: code, message: try errorMessage(&reader))
+            }
+
+            guard !reader.isEmpty else {
+                return nil
+            }
+            let count = try reader.decodeMapCount()
+            guard count != 0 else {
+                return nil
+            }
+
+            //body packed as [0x30 : MP_ARRAY]
+            for _ in 0..<count {
+                guard try reader.decodeInt() == 0x30 else {
+                    try reader.skip()
+                    continue
+                }
+                return try read(&reader)
+            }
+            throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+    }
+
+    //error packed as [0x31 : MP_STRING]
+    func errorMessage(_ reader: inout MessagePackReader) throws -> String {
+        guard !reader.isEmpty else {
+            return "nil"
+        }
+        let count = try reader.decodeMapCount()
+        for _ in 0..<count {
+            guard try reader.decodeInt() == 0x31 else {
+                try reader.skip()
+                continue
+            }
+            return try reader.decodeString()
+        }
+        return "nil"
+    }
+}
+
+func unpackRows(_ result: Tuple) throws -> [Tuple] {
+    return try result.map { row in
+        guard let tuple = Tuple(row) else {
+            throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+        return tuple
+    }
+}
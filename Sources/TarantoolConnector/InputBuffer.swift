@@ -0,0 +1,83 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Socket
+import Foundation
+
+// Connection-owned receive buffer. Reads as much as the socket has,
+// packet headers are parsed in place and consumed from the front,
+// the body of each response is copied out (see IProtoResponse.body).
+// Unread bytes are moved to the start instead of wrapping around,
+// so a packet is always contiguous for the decoder.
+final class InputBuffer {
+    static let readSize = 64 * 1024
+
+    var storage: UnsafeMutablePointer<UInt8>
+    var capacity: Int
+    var readIndex = 0
+    var writeIndex = 0
+
+    init(capacity: Int = InputBuffer.readSize) {
+        self.capacity = capacity
+        self.storage = UnsafeMutablePointer<UInt8>.allocate(capacity: capacity)
+    }
+
+    deinit {
+        storage.deallocate(capacity: capacity)
+    }
+
+    var count: Int {
+        return writeIndex - readIndex
+    }
+
+    var bytes: UnsafeBufferPointer<UInt8> {
+        return UnsafeBufferPointer(start: storage + readIndex, count: count)
+    }
+
+    func consume(_ count: Int) {
+        readIndex += count
+        if readIndex == writeIndex {
+            readIndex = 0
+            writeIndex = 0
+        }
+    }
+
+    func reserve(_ size: Int) {
+        guard capacity - writeIndex < size else {
+            return
+        }
+        let count = self.count
+        if readIndex > 0 && capacity - count >= size {
+            memmove(storage, storage + readIndex, count)
+        } else {
+            var newCapacity = capacity * 2
+            while newCapacity - count < size {
+                newCapacity *= 2
+            }
+            let newStorage = UnsafeMutablePointer<UInt8>.allocate(capacity: newCapacity)
+            newStorage.initialize(from: storage + readIndex, count: count)
+            storage.deallocate(capacity: capacity)
+            storage = newStorage
+            capacity = newCapacity
+        }
+        readIndex = 0
+        writeIndex = count
+    }
+
+    // one syscall, at least `size` bytes of free space
+    func read(from socket: Socket, size: Int = InputBuffer.readSize) throws {
+        reserve(size)
+        let read = try socket.read(to: storage + writeIndex, count: capacity - writeIndex)
+        guard read > 0 else {
+            throw IProtoError.connectionClosed
+        }
+        writeIndex += read
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Socket
+import Foundation
+
+// Queued requests are encoded back to back and written with one syscall.
+// The length prefix is reserved up front and patched once the packet
+// is complete, so nothing is copied or concatenated.
+final class OutputBuffer: MessagePackWriter {
+    var storage: UnsafeMutablePointer<UInt8>
+    var capacity: Int
+    var count = 0
+
+    init(capacity: Int = 16 * 1024) {
+        self.capacity = capacity
+        self.storage = UnsafeMutablePointer<UInt8>.allocate(capacity: capacity)
+    }
+
+    deinit {
+        storage.deallocate(capacity: capacity)
+    }
+
+    var isEmpty: Bool {
+        return count == 0
+    }
+
+    func reserve(_ size: Int) {
+        guard capacity - count < size else {
+            return
+        }
+        var newCapacity = capacity * 2
+        while newCapacity - count < size {
+            newCapacity *= 2
+        }
+        let newStorage = UnsafeMutablePointer<UInt8>.allocate(capacity: newCapacity)
+        newStorage.initialize(from: storage, count: count)
+        storage.deallocate(capacity: capacity)
+        storage = newStorage
+        capacity = newCapacity
+    }
+
+    func write(_ byte: UInt8) {
+        reserve(1)
+        storage[count] = byte
+        count += 1
+    }
+
+    func write(_ bytes: UnsafeBufferPointer<UInt8>) {
+        guard let source = bytes.baseAddress, bytes.count > 0 else {
+            return
+        }
+        reserve(bytes.count)
+        (storage + count).initialize(from: source, count: bytes.count)
+        count += bytes.count
+    }
+
+    func write(_ bytes: [UInt8]) {
+        bytes.withUnsafeBufferPointer { write($0) }
+    }
+
+    // 1/3 - header + body size, patched in endPacket
+    func beginPacket() -> Int {
+        let start = count
+        reserve(5)
+        count += 5
+        return start
+    }
+
+    func endPacket(_ start: Int) throws {
+        let length = try HeaderLength(count - start - 5)
+        length.write(to: storage + start)
+    }
+
+    // drops an unfinished packet, e.g. on encoding error
+    func cancelPacket(_ start: Int) {
+        count = start
+    }
+
+    func write(to socket: Socket) throws {
+        var written = 0
+        while written < count {
+            let sent = try socket.write(bytes: storage + written, count: count - written)
+            // no progress, the peer is gone
+            guard sent > 0 else {
+                throw IProtoError.connectionClosed
+            }
+            written += sent
+        }
+        count = 0
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+// Constant parts of a request encoded once: the header code pair and
+// the body map prefix. Per call only the sync and the variable body
+// fields are appended to the output buffer.
+struct PreparedRequest {
+    let header: [UInt8]
+    let body: [UInt8]
+
+    init(code: Code, bodyCount: Int, body constant: (Key, MessagePack)...) {
+        let header = MessagePackBytes()
+        header.encode(Key.code.rawValue)
+        header.encode(code.rawValue)
+        self.header = header.bytes
+
+        let body = MessagePackBytes()
+        body.encodeMapCount(bodyCount)
+        for (key, value) in constant {
+            body.encode(key.rawValue)
+            body.encode(value)
+        }
+        self.body = body.bytes
+    }
+}
+
+public struct PreparedSelect {
+    let request: PreparedRequest
+
+    public init(spaceId: Int, indexId: Int = 0, iterator: Iterator = .eq) {
+        request = PreparedRequest(code: .select, bodyCount: 6, body:
+            (.spaceId,  .int(spaceId)),
+            (.indexId,  .int(indexId)),
+            (.iterator, .int(iterator.rawValue)))
+    }
+}
+
+extension IProtoConnection {
+    public func select(_ prepared: PreparedSelect, keys: Tuple = [], offset: Int = 0, limit: Int = 1000) throws -> [Tuple] {
+        let result = try request(prepared.request) { output in
+            output.encode(Key.limit.rawValue)
+            output.encode(limit)
+            output.encode(Key.offset.rawValue)
+            output.encode(offset)
+            output.encode(Key.key.rawValue)
+            output.encode(keys)
+        }
+        return try unpackRows(result)
+    }
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+public typealias VClock = [Int : Int]
+
+public struct ReplicationEvent {
+    public enum Operation {
+        case insert
+        case replace
+        case update
+        case delete
+        case upsert
+    }
+
+    public let operation: Operation
+    public let spaceId: Int
+    public let indexId: Int
+    // the new tuple for insert, replace and upsert
+    public let tuple: Tuple
+    // the key for update and delete
+    public let keys: Tuple
+    // update and upsert operations
+    public let ops: Tuple
+    public let serverId: Int
+    public let lsn: Int
+    public let timestamp: Double
+}
+
+// Streams rows from the master's write ahead log with SUBSCRIBE.
+// The instance uuid must be registered in the master's _cluster
+// and the user needs the replication role.
+public final class ReplicationClient {
+    let connection: IProtoConnection
+    let instanceUUID: String
+    public private(set) var vclock: VClock
+
+    // called with the vclock of the last handled row
+    // every checkpointInterval rows and when run() returns
+    public var checkpoint: ((VClock) -> Void)?
+    public var checkpointInterval = 1000
+
+    // Seconds between vclock acks sent back to the master, match it
+    // with its replication_timeout. Sent when a row or a heartbeat
+    // arrives, masters since 1.7.4 drop replicas that stay silent.
+    public var ackInterval: TimeInterval = 1
+
+    public init(
+        host: String,
+        port: UInt16 = 3301,
+        credentials: IProtoPool.Credentials? = nil,
+        instanceUUID: String,
+        from vclock: VClock = [:],
+        awaiter: IOAwaiter? = nil
+    ) throws {
+        connection = try IProtoConnection(host: host, port: port, awaiter: awaiter)
+        if let credentials = credentials {
+            try connection.auth(username: credentials.username, chapSha1: credentials.chapSha1)
+        }
+        self.instanceUUID = instanceUUID
+        self.vclock = vclock
+    }
+
+    // the stream ends only with an error or stop()
+    public func run(_ handler: (ReplicationEvent) throws -> Void) throws {
+        let clusterUUID = try self.clusterUUID()
+        let vclock = self.vclock
+        _ = try connection.send(code: .subscribe, stampsSchema: false) { body in
+            body.encodeMapCount(3)
+            body.encode(Key.serverUUID.rawValue)
+            body.encode(instanceUUID)
+            body.encode(Key.clusterUUID.rawValue)
+            body.encode(clusterUUID)
+            body.encode(Key.vClock.rawValue)
+            body.encodeMapCount(vclock.count)
+            for (serverId, lsn) in vclock {
+                body.encode(serverId)
+                body.encode(lsn)
+            }
+        }
+
+        var sinceCheckpoint = 0
+        defer {
+            if sinceCheckpoint > 0 {
+                checkpoint?(self.vclock)
+            }
+        }
+
+        var lastAck = Date()
+        while true {
+            let packet = try connection.readPacket()
+            if Date().timeIntervalSince(lastAck) >= ackInterval {
+                try ack()
+                lastAck = Date()
+            }
+            guard let event = try ReplicationEvent(packet) else {
+                continue
+            }
+            try handler(event)
+            self.vclock[event.serverId] = event.lsn
+            sinceCheckpoint += 1
+            if sinceCheckpoint >= checkpointInterval {
+                checkpoint?(self.vclock)
+                sinceCheckpoint = 0
+            }
+        }
+    }
+
+    // the vclock of the handled rows, encoded like the master's heartbeat
+    func ack() throws {
+        let vclock = self.vclock
+        try connection.post(code: .ok) { body in
+            body.encodeMapCount(1)
+            body.encode(Key.vClock.rawValue)
+            body.encodeMapCount(vclock.count)
+            for (serverId, lsn) in vclock {
+                body.encode(serverId)
+                body.encode(lsn)
+            }
+        }
+    }
+
+    // makes run() throw connectionClosed
+    public func stop() {
+        connection.close()
+    }
+
+    // stored as ["cluster", uuid] in _schema
+    func clusterUUID() throws -> String {
+        let schema = IProtoDataSource(connection: connection)
+        guard let row = try schema.get(spaceId: 272, keys: [.string("cluster")], indexId: 0),
+            row.count >= 2, let uuid = String(row[1]) else {
+                throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+        return uuid
+    }
+}
+
+extension ReplicationEvent {
+    // nil for packets that are not rows, e.g. heartbeats
+    init?(_ packet: IProtoResponse) throws {
+        guard packet.code < 0x8000 else {
+            // the error message is in the body
+            _ = try packet.unpack()
+            return nil
+        }
+
+        let operation: Operation
+        switch packet.code {
+        case 0x02: operation = .insert
+        case 0x03: operation = .replace
+        case 0x04: operation = .update
+        case 0x05: operation = .delete
+        case 0x09: operation = .upsert
+        default: return nil
+        }
+
+        guard let serverId = packet.serverId, let lsn = packet.lsn else {
+            throw IProtoError.invalidPacket(reason: .invalidHeader)
+        }
+
+        var spaceId: Int?
+        var indexId = 0
+        var tuple = Tuple()
+        var keys = Tuple()
+        var ops = Tuple()
+        try packet.body.withUnsafeBufferPointer { bytes -> Void in
+            var reader = MessagePackReader(bytes: bytes)
+            let count = try reader.decodeMapCount()
+            for _ in 0..<count {
+                switch try reader.decodeInt() {
+                case 0x10: spaceId = try reader.decodeInt()
+                case 0x11: indexId = try reader.decodeInt()
+                case 0x20: keys = try ReplicationEvent.decodeTuple(&reader)
+                case 0x21: tuple = try ReplicationEvent.decodeTuple(&reader)
+                case 0x28: ops = try ReplicationEvent.decodeTuple(&reader)
+                default: try reader.skip()
+                }
+            }
+        }
+
+        guard let space = spaceId else {
+            throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+
+        // update ops travel under IPROTO_TUPLE
+        if operation == .update {
+            ops = tuple
+            tuple = []
+        }
+
+        self.operation = operation
+        self.spaceId = space
+        self.indexId = indexId
+        self.tuple = tuple
+        self.keys = keys
+        self.ops = ops
+        self.serverId = serverId
+        self.lsn = lsn
+        self.timestamp = packet.timestamp ?? 0
+    }
+
+    static func decodeTuple(_ reader: inout MessagePackReader) throws -> Tuple {
+        guard let tuple = Tuple(try reader.decode()) else {
+            throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+        return tuple
+    }
+}
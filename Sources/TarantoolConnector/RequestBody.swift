@@ -0,0 +1,107 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+extension OutputBuffer {
+    // header writes the code pair, body writes the whole body map;
+    // the packet is dropped if encoding fails
+    func writePacket(header: (OutputBuffer) -> Void, sync: Int, schemaId: MessagePack?, body: (OutputBuffer) throws -> Void) throws {
+        // 1/3 - header + body size
+        let start = beginPacket()
+        do {
+            // 2/3 - header - MP_MAP
+            encodeMapCount(schemaId == nil ? 2 : 3)
+            header(self)
+            encode(Key.sync.rawValue)
+            encode(sync)
+            if let schemaId = schemaId {
+                encode(Key.schemaId.rawValue)
+                encode(schemaId)
+            }
+
+            // 3/3 - body - MP_MAP
+            try body(self)
+            try endPacket(start)
+        } catch {
+            cancelPacket(start)
+            throw error
+        }
+    }
+}
+
+// 3/3 - body - MP_MAP, fields in a fixed order
+extension OutputBuffer {
+    func writeSelect(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) {
+        encodeMapCount(6)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.indexId.rawValue)
+        encode(indexId)
+        encode(Key.limit.rawValue)
+        encode(limit)
+        encode(Key.offset.rawValue)
+        encode(offset)
+        encode(Key.iterator.rawValue)
+        encode(iterator.rawValue)
+        encode(Key.key.rawValue)
+        encode(keys)
+    }
+
+    // insert and replace
+    func writeTuple(spaceId: Int, tuple: Tuple) {
+        encodeMapCount(2)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.tuple.rawValue)
+        encode(tuple)
+    }
+
+    func writeRecord<R: TarantoolRecord>(spaceId: Int, record: R) {
+        encodeMapCount(2)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.tuple.rawValue)
+        encode(record: record)
+    }
+
+    func writeDelete(spaceId: Int, keys: Tuple, indexId: Int) {
+        encodeMapCount(3)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.indexId.rawValue)
+        encode(indexId)
+        encode(Key.key.rawValue)
+        encode(keys)
+    }
+
+    // update ops go under IPROTO_TUPLE
+    func writeUpdate(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) {
+        encodeMapCount(4)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.indexId.rawValue)
+        encode(indexId)
+        encode(Key.key.rawValue)
+        encode(keys)
+        encode(Key.tuple.rawValue)
+        encode(ops)
+    }
+
+    func writeUpsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) {
+        encodeMapCount(4)
+        encode(Key.spaceId.rawValue)
+        encode(spaceId)
+        encode(Key.indexId.rawValue)
+        encode(indexId)
+        encode(Key.tuple.rawValue)
+        encode(tuple)
+        encode(Key.ops.rawValue)
+        encode(ops)
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Tarantool
+
+// Encodes whole request packets with the same code IProtoConnection
+// queues them with, but without a socket, e.g. for benchmarks.
+public final class RequestEncoder {
+    let output = OutputBuffer()
+    var sync = 0
+
+    public init() {}
+
+    // bytes encoded since the last reset
+    public var count: Int {
+        return output.count
+    }
+
+    public func reset() {
+        output.count = 0
+    }
+
+    public func select(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int = 0, offset: Int = 0, limit: Int = 1000) throws {
+        try packet(code: .select) { body in
+            body.writeSelect(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+
+    public func insert(spaceId: Int, tuple: Tuple) throws {
+        try packet(code: .insert) { body in
+            body.writeTuple(spaceId: spaceId, tuple: tuple)
+        }
+    }
+
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int = 0) throws {
+        try packet(code: .update) { body in
+            body.writeUpdate(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+        }
+    }
+
+    func packet(code: Code, body: (OutputBuffer) throws -> Void) throws {
+        sync += 1
+        try output.writePacket(header: { output in
+            output.encode(Key.code.rawValue)
+            output.encode(code.rawValue)
+        }, sync: sync, schemaId: nil, body: body)
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+typealias Words16 = (
+    UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32,
+    UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32)
+
+@inline(__always)
+fileprivate func rotateLeft(_ value: UInt32, _ count: UInt32) -> UInt32 {
+    return (value << count) | (value >> (32 - count))
+}
+
+// SHA-1 over fixed-size state, nothing is allocated on the heap
+struct SHA1 {
+    static let digestSize = 20
+    static let blockSize = 64
+
+    var h0: UInt32 = 0x67452301
+    var h1: UInt32 = 0xEFCDAB89
+    var h2: UInt32 = 0x98BADCFE
+    var h3: UInt32 = 0x10325476
+    var h4: UInt32 = 0xC3D2E1F0
+
+    // pending bytes of an incomplete block
+    var block: Words16 = (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+    var blockCount = 0
+    var length: UInt64 = 0
+
+    init() {}
+
+    mutating func update(_ bytes: UnsafeBufferPointer<UInt8>) {
+        guard var source = bytes.baseAddress else {
+            return
+        }
+        var count = bytes.count
+        length += UInt64(count)
+        while count > 0 {
+            let offset = blockCount
+            let chunk = min(SHA1.blockSize - offset, count)
+            withUnsafeMutableBytes(of: &block) { block in
+                (block.baseAddress! + offset).copyBytes(from: source, count: chunk)
+            }
+            blockCount += chunk
+            source += chunk
+            count -= chunk
+            if blockCount == SHA1.blockSize {
+                compress()
+                blockCount = 0
+            }
+        }
+    }
+
+    mutating func update(_ byte: UInt8) {
+        var byte = byte
+        withUnsafePointer(to: &byte) { pointer in
+            update(UnsafeBufferPointer(start: pointer, count: 1))
+        }
+    }
+
+    // writes digestSize bytes
+    mutating func finish(into digest: UnsafeMutablePointer<UInt8>) {
+        let bits = length << 3
+        update(0x80)
+        while blockCount != 56 {
+            update(0)
+        }
+        for shift in stride(from: 56, through: 0, by: -8) {
+            update(UInt8(truncatingBitPattern: bits >> UInt64(shift)))
+        }
+
+        store(h0, to: digest)
+        store(h1, to: digest + 4)
+        store(h2, to: digest + 8)
+        store(h3, to: digest + 12)
+        store(h4, to: digest + 16)
+    }
+
+    func store(_ word: UInt32, to pointer: UnsafeMutablePointer<UInt8>) {
+        pointer[0] = UInt8(truncatingBitPattern: word >> 24)
+        pointer[1] = UInt8(truncatingBitPattern: word >> 16)
+        pointer[2] = UInt8(truncatingBitPattern: word >> 8)
+        pointer[3] = UInt8(truncatingBitPattern: word)
+    }
+
+    static func hash(_ bytes: UnsafeBufferPointer<UInt8>, into digest: UnsafeMutablePointer<UInt8>) {
+        var sha1 = SHA1()
+        sha1.update(bytes)
+        sha1.finish(into: digest)
+    }
+
+    mutating func compress() {
+        // the message schedule is kept as a rolling window of 16 words
+        var w = block
+        var a = h0, b = h1, c = h2, d = h3, e = h4
+
+        withUnsafeMutableBytes(of: &w) { raw in
+            // big endian words in place of the bytes they are read from
+            let w = raw.baseAddress!.bindMemory(to: UInt32.self, capacity: 16)
+            for i in 0..<16 {
+                let word = UInt32(raw[i * 4]) << 24 | UInt32(raw[i * 4 + 1]) << 16
+                    | UInt32(raw[i * 4 + 2]) << 8 | UInt32(raw[i * 4 + 3])
+                w[i] = word
+            }
+
+            for t in 0..<80 {
+                let s = t & 15
+                if t >= 16 {
+                    w[s] = rotateLeft(w[(t + 13) & 15] ^ w[(t + 8) & 15] ^ w[(t + 2) & 15] ^ w[s], 1)
+                }
+
+                let f: UInt32
+                let k: UInt32
+                switch t {
+                case 0..<20:
+                    f = (b & c) | (~b & d)
+                    k = 0x5A827999
+                case 20..<40:
+                    f = b ^ c ^ d
+                    k = 0x6ED9EBA1
+                case 40..<60:
+                    f = (b & c) | (b & d) | (c & d)
+                    k = 0x8F1BBCDC
+                default:
+                    f = b ^ c ^ d
+                    k = 0xCA62C1D6
+                }
+
+                let temp = rotateLeft(a, 5) &+ f &+ e &+ k &+ w[s]
+                e = d
+                d = c
+                c = rotateLeft(b, 30)
+                b = a
+                a = temp
+            }
+        }
+
+        h0 = h0 &+ a
+        h1 = h1 &+ b
+        h2 = h2 &+ c
+        h3 = h3 &+ d
+        h4 = h4 &+ e
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+// Concurrent identical reads share one request to the source:
+// the first caller sends it, the others wait and get the same result
+// or the same error. Writes are passed through.
+public final class SingleFlightDataSource: DataSource {
+    final class Flight {
+        var rows: [Tuple] = []
+        var error: Error?
+        var isDone = false
+    }
+
+    let source: DataSource
+    let lock: Condition
+    var flights: [FlightKey : Flight] = [:]
+    var joined = 0
+
+    // FiberCondition inside tarantool, NSCondition for threads
+    public init(source: DataSource, lock: Condition = NSCondition()) {
+        self.source = source
+        self.lock = lock
+    }
+
+    // reads answered by someone else's request
+    public var coalesced: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return joined
+    }
+
+    public var schemaId: Int? {
+        return source.schemaId
+    }
+
+    func perform(_ key: FlightKey, _ request: (Void) throws -> [Tuple]) throws -> [Tuple] {
+        lock.lock()
+        if let flight = flights[key] {
+            joined += 1
+            while !flight.isDone {
+                lock.wait()
+            }
+            lock.unlock()
+            if let error = flight.error {
+                throw error
+            }
+            return flight.rows
+        }
+        let flight = Flight()
+        flights[key] = flight
+        lock.unlock()
+
+        var rows: [Tuple] = []
+        var requestError: Error?
+        do {
+            rows = try request()
+        } catch {
+            requestError = error
+        }
+
+        lock.lock()
+        flight.rows = rows
+        flight.error = requestError
+        flight.isDone = true
+        flights.removeValue(forKey: key)
+        lock.broadcast()
+        lock.unlock()
+
+        if let error = requestError {
+            throw error
+        }
+        return rows
+    }
+
+    public func select(spaceId: Int, iterator: Iterator, keys: Tuple, indexId: Int, offset: Int, limit: Int) throws -> [Tuple] {
+        let key = FlightKey(
+            kind: .select, spaceId: spaceId, indexId: indexId,
+            iterator: iterator, offset: offset, limit: limit, keys: keys)
+        return try perform(key) {
+            try source.select(spaceId: spaceId, iterator: iterator, keys: keys, indexId: indexId, offset: offset, limit: limit)
+        }
+    }
+
+    public func get(spaceId: Int, keys: Tuple, indexId: Int) throws -> Tuple? {
+        let key = FlightKey(
+            kind: .get, spaceId: spaceId, indexId: indexId,
+            iterator: .eq, offset: 0, limit: 1, keys: keys)
+        return try perform(key) {
+            guard let tuple = try source.get(spaceId: spaceId, keys: keys, indexId: indexId) else {
+                return []
+            }
+            return [tuple]
+        }.first
+    }
+
+    public func insert(spaceId: Int, tuple: Tuple) throws {
+        try source.insert(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func replace(spaceId: Int, tuple: Tuple) throws {
+        try source.replace(spaceId: spaceId, tuple: tuple)
+    }
+
+    public func delete(spaceId: Int, keys: Tuple, indexId: Int) throws {
+        try source.delete(spaceId: spaceId, keys: keys, indexId: indexId)
+    }
+
+    public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) throws {
+        try source.update(spaceId: spaceId, keys: keys, ops: ops, indexId: indexId)
+    }
+
+    public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) throws {
+        try source.upsert(spaceId: spaceId, tuple: tuple, ops: ops, indexId: indexId)
+    }
+}
+
+struct FlightKey: Hashable {
+    enum Kind: Int {
+        case get
+        case select
+    }
+
+    let kind: Kind
+    let spaceId: Int
+    let indexId: Int
+    let iterator: Iterator
+    let offset: Int
+    let limit: Int
+    let bytes: [UInt8]
+    let hashValue: Int
+
+    init(kind: Kind, spaceId: Int, indexId: Int, iterator: Iterator, offset: Int, limit: Int, keys: Tuple) {
+        let encoded = MessagePackBytes()
+        encoded.encode(keys)
+        self.kind = kind
+        self.spaceId = spaceId
+        self.indexId = indexId
+        self.iterator = iterator
+        self.offset = offset
+        self.limit = limit
+        self.bytes = encoded.bytes
+
+        var hash = FNV1a()
+        hash.combine(bytes)
+        hash.combine(kind.rawValue)
+        hash.combine(iterator.rawValue)
+        hash.combine(spaceId)
+        hash.combine(indexId)
+        hash.combine(offset)
+        hash.combine(limit)
+        self.hashValue = Int(bitPattern: hash.value)
+    }
+
+    static func ==(lhs: FlightKey, rhs: FlightKey) -> Bool {
+        return lhs.hashValue == rhs.hashValue
+            && lhs.kind == rhs.kind
+            && lhs.spaceId == rhs.spaceId
+            && lhs.indexId == rhs.indexId
+            && lhs.iterator == rhs.iterator
+            && lhs.offset == rhs.offset
+            && lhs.limit == rhs.limit
+            && lhs.bytes == rhs.bytes
+    }
+}
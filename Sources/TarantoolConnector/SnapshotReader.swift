@@ -0,0 +1,157 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import Foundation
+import Tarantool
+
+// Row of the snapshot, valid only inside the handler.
+// The tuple is decoded on demand straight from the packet bytes.
+public struct SnapshotRow {
+    public let spaceId: Int
+    let packet: IProtoResponse
+    let tupleOffset: Int
+
+    public func tuple() throws -> Tuple {
+        return try withTuple { reader -> Tuple in
+            guard let tuple = Tuple(try reader.decode()) else {
+                throw IProtoError.invalidPacket(reason: .invalidBody)
+            }
+            return tuple
+        }
+    }
+
+    public func decode<R: TarantoolRecord>(_ type: R.Type) throws -> R {
+        return try withTuple { reader in
+            try reader.decode(type)
+        }
+    }
+
+    func withTuple<T>(_ body: (inout MessagePackReader) throws -> T) throws -> T {
+        return try packet.body.withUnsafeBufferPointer { bytes -> T in
+            var reader = MessagePackReader(bytes: UnsafeBufferPointer(
+                start: bytes.baseAddress! + tupleOffset,
+                count: bytes.count - tupleOffset))
+            return try body(&reader)
+        }
+    }
+}
+
+// Streams the master's snapshot with JOIN, much faster than paging
+// select over every space: rows arrive back to back, one packet
+// at a time is kept in memory. JOIN registers instanceUUID in _cluster
+// and needs the replication role.
+//
+// The master answers JOIN with the vclock of its checkpoint, the rows
+// of that checkpoint, an OK marking the end of the initial stage, then
+// the final stage: WAL rows written since the checkpoint and one more OK.
+// Only the initial stage is read. The final stage holds updates and
+// deletes too, so it is left to a ReplicationClient subscribing from
+// the returned checkpoint vclock, which gets the same rows.
+public final class SnapshotReader {
+    let connection: IProtoConnection
+    let instanceUUID: String
+
+    public init(
+        host: String,
+        port: UInt16 = 3301,
+        credentials: IProtoPool.Credentials? = nil,
+        instanceUUID: String,
+        awaiter: IOAwaiter? = nil
+    ) throws {
+        connection = try IProtoConnection(host: host, port: port, awaiter: awaiter)
+        if let credentials = credentials {
+            try connection.auth(username: credentials.username, chapSha1: credentials.chapSha1)
+        }
+        self.instanceUUID = instanceUUID
+    }
+
+    // Returns the checkpoint vclock the rows were read at. The connection
+    // is closed afterwards, in the middle of the final stage.
+    public func read(_ handler: (SnapshotRow) throws -> Void) throws -> VClock {
+        defer { connection.close() }
+
+        _ = try connection.send(code: .join, stampsSchema: false) { body in
+            body.encodeMapCount(1)
+            body.encode(Key.serverUUID.rawValue)
+            body.encode(instanceUUID)
+        }
+
+        var start: VClock?
+        while true {
+            let packet = try connection.readPacket()
+            switch packet.code {
+            case 0x00:
+                guard let vclock = start else {
+                    // the checkpoint the rows come from
+                    start = try SnapshotReader.decodeVClock(packet)
+                    continue
+                }
+                // end of the initial stage
+                return vclock
+            // memtx sends inserts, other engines may send replaces
+            case 0x02, 0x03:
+                try handler(try SnapshotReader.decodeRow(packet))
+            case let code where code >= 0x8000:
+                // throws the error from the body
+                _ = try packet.unpack()
+                throw IProtoError.badRequest(code: code, message: "nil")
+            default:
+                // a row we can't express would leave the snapshot incomplete
+                throw IProtoError.invalidPacket(reason: .invalidHeader)
+            }
+        }
+    }
+
+    static func decodeRow(_ packet: IProtoResponse) throws -> SnapshotRow {
+        var spaceId: Int?
+        var tupleOffset: Int?
+        try packet.body.withUnsafeBufferPointer { bytes -> Void in
+            var reader = MessagePackReader(bytes: bytes)
+            let count = try reader.decodeMapCount()
+            for _ in 0..<count {
+                switch try reader.decodeInt() {
+                case 0x10: spaceId = try reader.decodeInt()
+                case 0x21:
+                    tupleOffset = reader.position
+                    try reader.skip()
+                default: try reader.skip()
+                }
+            }
+        }
+        guard let space = spaceId, let offset = tupleOffset else {
+            throw IProtoError.invalidPacket(reason: .invalidBody)
+        }
+        return SnapshotRow(spaceId: space, packet: packet, tupleOffset: offset)
+    }
+
+    // body packed as [0x26 : MP_MAP {server id : lsn}]
+    static func decodeVClock(_ packet: IProtoResponse) throws -> VClock {
+        var vclock = VClock()
+        try packet.body.withUnsafeBufferPointer { bytes -> Void in
+            var reader = MessagePackReader(bytes: bytes)
+            guard !reader.isEmpty else {
+                return
+            }
+            let count = try reader.decodeMapCount()
+            for _ in 0..<count {
+                guard try reader.decodeInt() == 0x26 else {
+                    try reader.skip()
+                    continue
+                }
+                let servers = try reader.decodeMapCount()
+                for _ in 0..<servers {
+                    let serverId = try reader.decodeInt()
+                    vclock[serverId] = try reader.decodeInt()
+                }
+            }
+        }
+        return vclock
+    }
+}
@@ -26,6 +26,43 @@ struct Welcome {
     var isValid: Bool {
         return header.hasPrefix("Tarantool")
     }
+
+    // decodes the first count bytes of the base64 salt
+    func decodeSalt(into target: UnsafeMutablePointer<UInt8>, count: Int) throws {
+        var bits: UInt32 = 0
+        var bitCount: UInt32 = 0
+        var written = 0
+        for index in headerSize..<headerSize+saltSize {
+            guard written < count else {
+                break
+            }
+            guard let value = base64Value(buffer[index]) else {
+                throw IProtoError.invalidSalt
+            }
+            bits = (bits << 6) | value
+            bitCount += 6
+            if bitCount >= 8 {
+                bitCount -= 8
+                target[written] = UInt8(truncatingBitPattern: bits >> bitCount)
+                bits &= (1 << bitCount) - 1
+                written += 1
+            }
+        }
+        guard written == count else {
+            throw IProtoError.invalidSalt
+        }
+    }
+}
+
+fileprivate func base64Value(_ char: UInt8) -> UInt32? {
+    switch char {
+    case UInt8(ascii: "A")...UInt8(ascii: "Z"): return UInt32(char - UInt8(ascii: "A"))
+    case UInt8(ascii: "a")...UInt8(ascii: "z"): return UInt32(char - UInt8(ascii: "a")) + 26
+    case UInt8(ascii: "0")...UInt8(ascii: "9"): return UInt32(char - UInt8(ascii: "0")) + 52
+    case UInt8(ascii: "+"): return 62
+    case UInt8(ascii: "/"): return 63
+    default: return nil
+    }
 }
 
 fileprivate extension String {
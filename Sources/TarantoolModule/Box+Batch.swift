@@ -0,0 +1,133 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import Tarantool
+
+extension Box {
+    enum BatchOperation {
+        case insert
+        case replace
+        case upsert(ops: Tuple, indexId: UInt32)
+    }
+
+    // Rows are applied in chunks of `yieldEvery`, each chunk is encoded
+    // into one region allocation and committed in its own transaction,
+    // then the fiber yields so others are not starved.
+    // With singleTransaction (or inside the caller's transaction)
+    // everything is applied at once and never yields.
+    static func batch(spaceId: UInt32, tuples: [Tuple], operation: BatchOperation, yieldEvery: Int, singleTransaction: Bool) throws {
+        let ownsTransaction = !box_txn()
+        let chunked = ownsTransaction && !singleTransaction
+        let chunkSize = chunked ? max(yieldEvery, 1) : max(tuples.count, 1)
+
+        if ownsTransaction && !chunked {
+            try Transaction.begin()
+        }
+
+        var start = 0
+        while start < tuples.count {
+            let end = min(start + chunkSize, tuples.count)
+            if chunked {
+                try Transaction.begin()
+            }
+            do {
+                try apply(spaceId: spaceId, tuples: tuples[start..<end], operation: operation)
+            } catch {
+                if ownsTransaction {
+                    try? Transaction.rollback()
+                }
+                throw error
+            }
+            if chunked {
+                try Transaction.commit()
+                if end < tuples.count {
+                    fiber_reschedule()
+                }
+            }
+            start = end
+        }
+
+        if ownsTransaction && !chunked {
+            try Transaction.commit()
+        }
+    }
+
+    static func apply(spaceId: UInt32, tuples: ArraySlice<Tuple>, operation: BatchOperation) throws {
+        // one region allocation for the whole chunk
+        counter.count = 0
+        for tuple in tuples {
+            counter.encode(tuple)
+        }
+        if case let .upsert(ops, _) = operation {
+            counter.encode(ops)
+        }
+        try region.allocate(max(counter.count, 1))
+
+        var ops: RegionBytes?
+        if case let .upsert(upsertOps, _) = operation {
+            region.encode(upsertOps)
+            ops = region.bytes
+        }
+
+        for tuple in tuples {
+            let start = region.count
+            region.encode(tuple)
+            let bytes = region.bytes
+            let tupleStart = bytes.start + start
+
+            let result: Int32
+            switch operation {
+            case .insert:
+                result = box_insert(spaceId, tupleStart, bytes.end, nil)
+            case .replace:
+                result = box_replace(spaceId, tupleStart, bytes.end, nil)
+            case let .upsert(_, indexId):
+                result = box_upsert(spaceId, indexId, tupleStart, bytes.end, ops!.start, ops!.end, 0, nil)
+            }
+            guard result == 0 else {
+                throw BoxError()
+            }
+        }
+    }
+}
+
+extension Space {
+    // BoxDataSource only, other sources apply the rows one by one
+    public func insertMany(_ tuples: [Tuple], yieldEvery: Int = 1000, singleTransaction: Bool = false) throws {
+        guard source is BoxDataSource else {
+            for tuple in tuples {
+                try insert(tuple)
+            }
+            return
+        }
+        try Box.batch(spaceId: UInt32(id), tuples: tuples, operation: .insert, yieldEvery: yieldEvery, singleTransaction: singleTransaction)
+    }
+
+    public func replaceMany(_ tuples: [Tuple], yieldEvery: Int = 1000, singleTransaction: Bool = false) throws {
+        guard source is BoxDataSource else {
+            for tuple in tuples {
+                try replace(tuple)
+            }
+            return
+        }
+        try Box.batch(spaceId: UInt32(id), tuples: tuples, operation: .replace, yieldEvery: yieldEvery, singleTransaction: singleTransaction)
+    }
+
+    public func upsertMany(_ tuples: [Tuple], ops: Tuple = [], indexId: Int = 0, yieldEvery: Int = 1000, singleTransaction: Bool = false) throws {
+        guard source is BoxDataSource else {
+            for tuple in tuples {
+                try upsert(tuple, ops: ops, indexId: indexId)
+            }
+            return
+        }
+        try Box.batch(spaceId: UInt32(id), tuples: tuples, operation: .upsert(ops: ops, indexId: UInt32(indexId)), yieldEvery: yieldEvery, singleTransaction: singleTransaction)
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import Tarantool
+
+final class OffloadTask {
+    let run: (Void) -> Void
+
+    init(_ run: @escaping (Void) -> Void) {
+        self.run = run
+    }
+}
+
+extension Box {
+    // Runs body on the coio thread pool, the calling fiber yields
+    // until it's done and other fibers keep running on the tx thread.
+    // body runs on another thread: no box, fiber or region calls inside.
+    public static func offload<T>(_ body: @escaping (Void) throws -> T) throws -> T {
+        var result: T?
+        var error: Error?
+        let task = OffloadTask {
+            do {
+                result = try body()
+            } catch let bodyError {
+                error = bodyError
+            }
+        }
+
+        let status = withExtendedLifetime(task) {
+            coio_call_wrapper(Unmanaged.passUnretained(task).toOpaque(), { pointer in
+                Unmanaged<OffloadTask>.fromOpaque(pointer!).takeUnretainedValue().run()
+            })
+        }
+        // -1 with errno = ENOMEM only if the task can't be allocated,
+        // the diagnostics area is not set
+        guard status == 0 else {
+            throw TarantoolError.notEnoughMemory
+        }
+
+        if let error = error {
+            throw error
+        }
+        return result!
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import Tarantool
+
+extension TupleView {
+    // fields are read in place from the tuple memory
+    public func decode<R: TarantoolRecord>(_ type: R.Type) throws -> R {
+        let expected = R.fields.count
+        guard count >= expected else {
+            throw TarantoolError.invalidTuple(message: "expected \(expected) fields, got \(count)")
+        }
+        guard expected > 0 else {
+            var empty = MessagePackReader(bytes: UnsafeBufferPointer(start: nil, count: 0))
+            return try R(from: &empty)
+        }
+        guard var reader = field(at: 0) else {
+            throw TarantoolError.invalidTuple(message: "can't read the first field")
+        }
+        return try R(from: &reader)
+    }
+}
+
+extension Box {
+    static func select<R: TarantoolRecord>(_ type: R.Type, spaceId: UInt32, iterator: Iterator, indexId: UInt32, keys: Tuple, offset: Int = 0, limit: Int = Int.max) throws -> [R] {
+        let iterator = try BoxIterator(spaceId: spaceId, indexId: indexId, iterator: iterator, keys: keys, offset: offset, limit: limit)
+
+        var rows: [R] = []
+        while let tuple = try iterator.nextTuple() {
+            rows.append(try tuple.decode(type))
+        }
+        return rows
+    }
+
+    static func get<R: TarantoolRecord>(_ type: R.Type, spaceId: UInt32, indexId: UInt32, keys: Tuple) throws -> R? {
+        return try getView(spaceId: spaceId, indexId: indexId, keys: keys).map { tuple in
+            try tuple.decode(type)
+        }
+    }
+
+    static func insert<R: TarantoolRecord>(spaceId: UInt32, record: R) throws {
+        let tuple = try encode { writer in
+            writer.encode(record: record)
+        }
+        guard box_insert(spaceId, tuple.start, tuple.end, nil) == 0 else {
+            throw BoxError()
+        }
+    }
+
+    static func replace<R: TarantoolRecord>(spaceId: UInt32, record: R) throws {
+        let tuple = try encode { writer in
+            writer.encode(record: record)
+        }
+        guard box_replace(spaceId, tuple.start, tuple.end, nil) == 0 else {
+            throw BoxError()
+        }
+    }
+
+    public static func returnRecord<R: TarantoolRecord>(_ record: R, to context: OpaquePointer) -> Int32 {
+        guard let tuple = try? encode({ writer in writer.encode(record: record) }),
+            let boxTuple = box_tuple_new(box_tuple_format_default(), tuple.start, tuple.end) else {
+                return -1
+        }
+        return box_return_tuple(context, boxTuple)
+    }
+}
+
+extension BoxDataSource: RecordDataSource {
+    public func select<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, iterator: Iterator, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = Int.max) throws -> [R] {
+        return try Box.select(type, spaceId: UInt32(spaceId), iterator: iterator, indexId: UInt32(indexId), keys: keys, offset: offset, limit: limit)
+    }
+
+    public func get<R: TarantoolRecord>(_ type: R.Type, spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> R? {
+        return try Box.get(type, spaceId: UInt32(spaceId), indexId: UInt32(indexId), keys: keys)
+    }
+
+    public func insert<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try Box.insert(spaceId: UInt32(spaceId), record: record)
+    }
+
+    public func replace<R: TarantoolRecord>(spaceId: Int, record: R) throws {
+        try Box.replace(spaceId: UInt32(spaceId), record: record)
+    }
+}
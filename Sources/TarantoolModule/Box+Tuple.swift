@@ -14,29 +14,59 @@ import MessagePack
 
 extension Box {
     static func unpackTuple(_ tuple: OpaquePointer) throws -> Tuple {
-        let size = box_tuple_bsize(tuple)
-        guard size > 0 else {
-            throw TarantoolError.invalidTuple(message: "tuple size: \(size)")
-        }
-        let packed = UnsafeMutablePointer<UInt8>.allocate(capacity: size)
-        defer { packed.deallocate(capacity: size) }
-        // copying internal tuple buffer
-        let written = packed.withMemoryRebound(to: CChar.self, capacity: size) { pointer in
-            return box_tuple_to_buf(tuple, pointer, size)
+        // decoding in place, no box_tuple_to_buf copy
+        return try TupleView(tuple).unpack()
+    }
+
+    public static func returnTuple(_ tuple: Tuple, to context: OpaquePointer) -> Int32 {
+        guard let bytes = try? encode(tuple),
+            let tuple = box_tuple_new(box_tuple_format_default(), bytes.start, bytes.end) else {
+                return -1
         }
+        return box_return_tuple(context, tuple)
+    }
 
-        let unpacked = try MessagePack.deserialize(bytes: UnsafeBufferPointer(start: packed, count: written))
-        guard let tuple = Tuple(unpacked) else {
-            throw TarantoolError.invalidTuple(message: "array result was expected")
+    public static func returnTuples(_ tuples: [Tuple], to context: OpaquePointer) -> Int32 {
+        for tuple in tuples {
+            let result = returnTuple(tuple, to: context)
+            guard result == 0 else {
+                return result
+            }
         }
+        return 0
+    }
 
-        return tuple
+    // existing box tuple, no decode / encode / copy;
+    // box_return_tuple takes its own reference
+    public static func returnTuple(_ tuple: TupleView, to context: OpaquePointer) -> Int32 {
+        return box_return_tuple(context, tuple.pointer)
     }
 
-    public static func returnTuple(_ tuple: Tuple, to context: OpaquePointer) -> Int32 {
-        let bytes = MessagePack.serialize(.array(tuple))
-        let pointer = UnsafeRawPointer(bytes).assumingMemoryBound(to: Int8.self)
-        let tuple = box_tuple_new(box_tuple_format_default(), pointer, pointer+bytes.count)
-        return box_return_tuple(context, tuple)
+    // fails the call instead of returning a truncated result,
+    // box diag is already set by the failed box_iterator_next
+    public static func returnTuples(_ iterator: BoxIterator, to context: OpaquePointer) -> Int32 {
+        do {
+            while let tuple = try iterator.nextTuple() {
+                let result = box_return_tuple(context, tuple.pointer)
+                guard result == 0 else {
+                    return result
+                }
+            }
+            return 0
+        } catch {
+            return -1
+        }
+    }
+
+    // multi-return of tuple views
+    public static func returnTuples<S: Sequence>(_ tuples: S, to context: OpaquePointer) -> Int32
+        where S.Iterator.Element == TupleView {
+        for tuple in tuples {
+            let result = box_return_tuple(context, tuple.pointer)
+            guard result == 0 else {
+                return result
+            }
+        }
+        return 0
     }
 }
@@ -29,13 +29,4 @@ extension Box {
         }
         return id
     }
-
-    static func copyToInternalMemory(_ bytes: [UInt8]) throws -> UnsafePointer<CChar> {
-        // will be deallocated on the fiber death
-        guard let buffer = box_txn_alloc(bytes.count) else {
-            throw TarantoolError.notEnoughMemory
-        }
-        memcpy(buffer, bytes, bytes.count)
-        return UnsafeRawPointer(buffer).assumingMemoryBound(to: CChar.self)
-    }
 }
@@ -13,78 +13,66 @@ import MessagePack
 import Foundation
 
 public struct Box {
-    static func select(spaceId: UInt32, iterator: Iterator, indexId: UInt32, keys: [UInt8]) throws -> [Tuple] {
-        let pointer = UnsafeRawPointer(keys).assumingMemoryBound(to: CChar.self)
-        guard let iterator = box_index_iterator(spaceId, indexId, Int32(iterator.rawValue), pointer, pointer+keys.count) else {
-            throw BoxError()
-        }
-        defer { box_iterator_free(iterator) }
+    static func select(spaceId: UInt32, iterator: Iterator, indexId: UInt32, keys: Tuple, offset: Int = 0, limit: Int = Int.max) throws -> [Tuple] {
+        let iterator = try BoxIterator(spaceId: spaceId, indexId: indexId, iterator: iterator, keys: keys, offset: offset, limit: limit)
 
         var rows: [Tuple] = []
-
-        let resultPointer = UnsafeMutablePointer<OpaquePointer?>.allocate(capacity: 1)
-        defer { resultPointer.deallocate(capacity: 1) }
-
-        while true {
-            guard box_iterator_next(iterator, resultPointer) == 0 else {
-                throw BoxError()
-            }
-            guard let tuple = resultPointer.pointee else {
-                break
-            }
-            rows.append(try unpackTuple(tuple))
+        while let tuple = try iterator.nextTuple() {
+            rows.append(try tuple.unpack())
         }
-
         return rows
     }
 
-    static func get(spaceId: UInt32, indexId: UInt32, keys: [UInt8]) throws -> Tuple? {
-        let resultPointer = UnsafeMutablePointer<OpaquePointer?>.allocate(capacity: 1)
-        defer { resultPointer.deallocate(capacity: 1) }
+    static func get(spaceId: UInt32, indexId: UInt32, keys: Tuple) throws -> Tuple? {
+        return try getTuple(spaceId: spaceId, indexId: indexId, keys: keys).map(unpackTuple)
+    }
+
+    static func getView(spaceId: UInt32, indexId: UInt32, keys: Tuple) throws -> TupleView? {
+        return try getTuple(spaceId: spaceId, indexId: indexId, keys: keys).map(TupleView.init)
+    }
 
-        let pKeys = UnsafeRawPointer(keys).assumingMemoryBound(to: CChar.self)
-        guard box_index_get(spaceId, indexId, pKeys, pKeys+keys.count, resultPointer) == 0 else {
+    static func getTuple(spaceId: UInt32, indexId: UInt32, keys: Tuple) throws -> OpaquePointer? {
+        let keys = try encode(keys)
+        var result: OpaquePointer?
+        guard box_index_get(spaceId, indexId, keys.start, keys.end, &result) == 0 else {
             throw BoxError()
         }
-        guard let tuple = resultPointer.pointee else {
-            return nil
-        }
-        return try unpackTuple(tuple)
+        return result
     }
 
-    static func insert(spaceId: UInt32, tuple: [UInt8]) throws {
-        let pointer = try copyToInternalMemory(tuple)
-        guard box_insert(spaceId, pointer, pointer+tuple.count, nil) == 0 else {
+    static func insert(spaceId: UInt32, tuple: Tuple) throws {
+        let tuple = try encode(tuple)
+        guard box_insert(spaceId, tuple.start, tuple.end, nil) == 0 else {
             throw BoxError()
         }
     }
 
-    static func replace(spaceId: UInt32, tuple: [UInt8]) throws {
-        let pointer = try copyToInternalMemory(tuple)
-        guard box_replace(spaceId, pointer, pointer+tuple.count, nil) == 0 else {
+    static func replace(spaceId: UInt32, tuple: Tuple) throws {
+        let tuple = try encode(tuple)
+        guard box_replace(spaceId, tuple.start, tuple.end, nil) == 0 else {
             throw BoxError()
         }
     }
 
-    static func update(spaceId: UInt32, indexId: UInt32, keys: [UInt8], ops: [UInt8]) throws {
-        let pKeys = try copyToInternalMemory(keys)
-        let pOps = try copyToInternalMemory(ops)
-        guard box_update(spaceId, indexId, pKeys, pKeys+keys.count, pOps, pOps+ops.count, 0, nil) == 0 else {
+    static func update(spaceId: UInt32, indexId: UInt32, keys: Tuple, ops: Tuple) throws {
+        let keys = try encode(keys)
+        let ops = try encode(ops)
+        guard box_update(spaceId, indexId, keys.start, keys.end, ops.start, ops.end, 0, nil) == 0 else {
             throw BoxError()
         }
     }
 
-    static func upsert(spaceId: UInt32, indexId: UInt32, tuple: [UInt8], ops: [UInt8]) throws {
-        let pTuple = try copyToInternalMemory(tuple)
-        let pOps = try copyToInternalMemory(ops)
-        guard box_update(spaceId, indexId, pTuple, pTuple+tuple.count, pOps, pOps+ops.count, 0, nil) == 0 else {
+    static func upsert(spaceId: UInt32, indexId: UInt32, tuple: Tuple, ops: Tuple) throws {
+        let tuple = try encode(tuple)
+        let ops = try encode(ops)
+        guard box_upsert(spaceId, indexId, tuple.start, tuple.end, ops.start, ops.end, 0, nil) == 0 else {
             throw BoxError()
         }
     }
 
-    static func delete(spaceId: UInt32, indexId: UInt32, keys: [UInt8]) throws{
-        let pointer = UnsafeRawPointer(keys).assumingMemoryBound(to: CChar.self)
-        guard box_delete(spaceId, indexId, pointer, pointer+keys.count, nil) == 0 else {
+    static func delete(spaceId: UInt32, indexId: UInt32, keys: Tuple) throws {
+        let keys = try encode(keys)
+        guard box_delete(spaceId, indexId, keys.start, keys.end, nil) == 0 else {
             throw BoxError()
         }
     }
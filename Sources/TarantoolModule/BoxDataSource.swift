@@ -16,40 +16,50 @@ import MessagePack
 public struct BoxDataSource: DataSource {
     public init() {}
 
+    // Resolved by the box schema on every call, so always current
+    // and much cheaper than loading a Schema from _vspace.
+    public func space(_ name: String) throws -> Space {
+        let id = try Box.getSpaceIdByName([UInt8](name.utf8))
+        return Space(id: Int(id), name: name, source: self)
+    }
+
+    public func indexId(_ name: String, spaceId: Int) throws -> Int {
+        return Int(try Box.getIndexIdByName([UInt8](name.utf8), spaceId: UInt32(spaceId)))
+    }
+
     public func select(spaceId: Int, iterator: Iterator, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = Int.max) throws -> [Tuple] {
-        let keys = MessagePack.serialize(.array(keys))
-        return try Box.select(spaceId: UInt32(spaceId), iterator: iterator, indexId: UInt32(indexId), keys: keys)
+        return try Box.select(spaceId: UInt32(spaceId), iterator: iterator, indexId: UInt32(indexId), keys: keys, offset: offset, limit: limit)
+    }
+
+    public func scan(spaceId: Int, iterator: Iterator, keys: Tuple = [], indexId: Int = 0, offset: Int = 0, limit: Int = Int.max) throws -> BoxIterator {
+        return try BoxIterator(spaceId: UInt32(spaceId), indexId: UInt32(indexId), iterator: iterator, keys: keys, offset: offset, limit: limit)
     }
 
     public func get(spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> Tuple? {
-        let keys = MessagePack.serialize(.array(keys))
         return try Box.get(spaceId: UInt32(spaceId), indexId: UInt32(indexId), keys: keys)
     }
 
+    public func getView(spaceId: Int, keys: Tuple, indexId: Int = 0) throws -> TupleView? {
+        return try Box.getView(spaceId: UInt32(spaceId), indexId: UInt32(indexId), keys: keys)
+    }
+
     public func insert(spaceId: Int, tuple: Tuple) throws {
-        let tuple = MessagePack.serialize(.array(tuple))
         try Box.insert(spaceId: UInt32(spaceId), tuple: tuple)
     }
 
     public func replace(spaceId: Int, tuple: Tuple) throws {
-        let tuple = MessagePack.serialize(.array(tuple))
         try Box.replace(spaceId: UInt32(spaceId), tuple: tuple)
     }
 
     public func delete(spaceId: Int, keys: Tuple, indexId: Int) throws {
-        let keys = MessagePack.serialize(.array(keys))
         try Box.delete(spaceId: UInt32(spaceId), indexId: UInt32(indexId), keys: keys)
     }
 
     public func update(spaceId: Int, keys: Tuple, ops: Tuple, indexId: Int) throws {
-        let keys = MessagePack.serialize(.array(keys))
-        let ops = MessagePack.serialize(.array(ops))
         try Box.update(spaceId: UInt32(spaceId), indexId: UInt32(indexId), keys: keys, ops: ops)
     }
 
     public func upsert(spaceId: Int, tuple: Tuple, ops: Tuple, indexId: Int) throws {
-        let tuple = MessagePack.serialize(.array(tuple))
-        let ops = MessagePack.serialize(.array(ops))
         try Box.upsert(spaceId: UInt32(spaceId), indexId: UInt32(indexId), tuple: tuple, ops: ops)
     }
 }
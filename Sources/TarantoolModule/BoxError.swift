@@ -14,7 +14,7 @@ public struct BoxError: Error {
     public let code: Int
     public let message: String
 
-    init(){
+    public init() {
         guard let errorPointer = box_error_last() else {
             self.code = 0
             self.message = "success"
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+
+// Lazy select over box_index_iterator: rows are fetched one at a time,
+// offset rows are skipped without being decoded, the iterator is freed
+// as soon as the sequence is dropped or exhausted.
+public final class BoxIterator: Sequence, IteratorProtocol {
+    let iterator: OpaquePointer
+    // the index iterator may point into the key, keep our own copy
+    let keys: UnsafeMutablePointer<UInt8>
+    let keysCount: Int
+    var offset: Int
+    var limit: Int
+
+    // set if box_iterator_next failed, the sequence ends early then;
+    // check it after for-in or use nextTuple()
+    public private(set) var error: BoxError?
+
+    init(spaceId: UInt32, indexId: UInt32, iterator: Iterator, keys: Tuple, offset: Int = 0, limit: Int = Int.max) throws {
+        // region memory may be gone before the iterator is
+        let region = try Box.encode(keys)
+        let copy = UnsafeMutablePointer<UInt8>.allocate(capacity: max(region.count, 1))
+        UnsafeMutableRawPointer(copy).copyBytes(from: region.start, count: region.count)
+        self.keys = copy
+        self.keysCount = region.count
+        self.offset = offset
+        self.limit = limit
+
+        let pointer = UnsafeRawPointer(self.keys).assumingMemoryBound(to: CChar.self)
+        guard let boxIterator = box_index_iterator(spaceId, indexId, Int32(iterator.rawValue), pointer, pointer+keysCount) else {
+            self.keys.deallocate(capacity: max(keysCount, 1))
+            throw BoxError()
+        }
+        self.iterator = boxIterator
+    }
+
+    deinit {
+        box_iterator_free(iterator)
+        keys.deallocate(capacity: max(keysCount, 1))
+    }
+
+    func nextPointer() throws -> OpaquePointer? {
+        var result: OpaquePointer?
+        guard box_iterator_next(iterator, &result) == 0 else {
+            throw BoxError()
+        }
+        return result
+    }
+
+    public func nextTuple() throws -> TupleView? {
+        guard limit > 0 else {
+            return nil
+        }
+        while offset > 0 {
+            guard try nextPointer() != nil else {
+                limit = 0
+                return nil
+            }
+            offset -= 1
+        }
+        guard let tuple = try nextPointer() else {
+            limit = 0
+            return nil
+        }
+        limit -= 1
+        return try TupleView(tuple)
+    }
+
+    public func next() -> TupleView? {
+        do {
+            return try nextTuple()
+        } catch {
+            self.error = error as? BoxError
+            Say.error(message: "box iterator failed: \(error)")
+            limit = 0
+            return nil
+        }
+    }
+}
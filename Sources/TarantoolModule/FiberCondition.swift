@@ -0,0 +1,74 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import Tarantool
+import Foundation
+
+public final class FiberCondition: Condition {
+    var waiters: [OpaquePointer] = []
+
+    public init() {}
+
+    // fibers are cooperative, there is nothing to lock
+    public func lock() {}
+    public func unlock() {}
+
+    public func wait() {
+        guard let current = fiber_self() else {
+            return
+        }
+        waiters.append(current)
+        fiber_yield()
+        // woken up by someone else, e.g. fiber_cancel
+        if let index = waiters.index(where: { $0 == current }) {
+            waiters.remove(at: index)
+        }
+    }
+
+    // fiber_sleep is woken up early by fiber_wakeup and fiber_cancel
+    public func wait(until deadline: Date) -> Bool {
+        guard let current = fiber_self() else {
+            return false
+        }
+        let timeout = deadline.timeIntervalSince(Date())
+        guard timeout > 0 else {
+            return false
+        }
+        waiters.append(current)
+        fiber_sleep(timeout)
+        guard let index = waiters.index(where: { $0 == current }) else {
+            // removed by broadcast
+            return true
+        }
+        waiters.remove(at: index)
+        return false
+    }
+
+    public var isCancelled: Bool {
+        return fiber_is_cancelled()
+    }
+
+    // wakes up the longest waiting fiber only
+    public func signal() {
+        guard !waiters.isEmpty else {
+            return
+        }
+        fiber_wakeup(waiters.removeFirst())
+    }
+
+    public func broadcast() {
+        let waiters = self.waiters
+        self.waiters.removeAll()
+        for waiter in waiters {
+            fiber_wakeup(waiter)
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+// Fixed set of worker fibers fed from a task queue,
+// so short tasks don't pay for fiber creation each time.
+// Workers keep the pool alive until close() is called.
+public final class FiberPool {
+    public struct Metrics {
+        public let queued: Int
+        public let running: Int
+        public let completed: Int
+    }
+
+    public let size: Int
+    // submitters yield while the queue is this deep, nil is unbounded
+    public let maxQueued: Int?
+
+    var tasks: [(Void) -> Void] = []
+    var head = 0
+    var running = 0
+    var completed = 0
+    var isClosed = false
+
+    let hasTasks = FiberCondition()
+    let hasRoom = FiberCondition()
+
+    public init(size: Int = 16, maxQueued: Int? = nil, name: String = "swift_pool") throws {
+        precondition(size > 0, "pool size must be positive")
+        self.size = size
+        self.maxQueued = maxQueued
+        for _ in 0..<size {
+            guard fiber(name: name, { self.work() }) else {
+                close()
+                throw BoxError()
+            }
+        }
+    }
+
+    public var queued: Int {
+        return tasks.count - head
+    }
+
+    public var metrics: Metrics {
+        return Metrics(queued: queued, running: running, completed: completed)
+    }
+
+    // yields the calling fiber while the queue is full,
+    // returns false if the pool is or gets closed meanwhile
+    @discardableResult
+    public func async(_ task: @escaping (Void) -> Void) -> Bool {
+        if let maxQueued = maxQueued {
+            while queued >= maxQueued && !isClosed {
+                hasRoom.wait()
+            }
+        }
+        return enqueue(task)
+    }
+
+    // returns false instead of waiting if the queue is full
+    @discardableResult
+    public func tryAsync(_ task: @escaping (Void) -> Void) -> Bool {
+        if let maxQueued = maxQueued, queued >= maxQueued {
+            return false
+        }
+        return enqueue(task)
+    }
+
+    // workers finish the queued tasks and exit
+    public func close() {
+        isClosed = true
+        hasTasks.broadcast()
+        hasRoom.broadcast()
+    }
+
+    // tasks submitted after close() are rejected, nobody would run them
+    func enqueue(_ task: @escaping (Void) -> Void) -> Bool {
+        guard !isClosed else {
+            return false
+        }
+        tasks.append(task)
+        hasTasks.signal()
+        return true
+    }
+
+    func dequeue() -> ((Void) -> Void)? {
+        guard head < tasks.count else {
+            return nil
+        }
+        let task = tasks[head]
+        head += 1
+        // drop the consumed prefix once it dominates the storage
+        if head >= 1024 && head * 2 >= tasks.count {
+            tasks.removeFirst(head)
+            head = 0
+        } else if head == tasks.count {
+            tasks.removeAll(keepingCapacity: true)
+            head = 0
+        }
+        return task
+    }
+
+    func work() {
+        while true {
+            guard let task = dequeue() else {
+                guard !isClosed else {
+                    return
+                }
+                hasTasks.wait()
+                continue
+            }
+            hasRoom.signal()
+            running += 1
+            task()
+            running -= 1
+            completed += 1
+        }
+    }
+}
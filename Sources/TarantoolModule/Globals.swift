@@ -12,12 +12,30 @@ import Async
 import CTarantool
 import Foundation
 
-@inline(__always)
-public func fiber(_ closure: @escaping (Void) -> Void) {
-    var closure = closure
-    fiber_wrapper(&closure, { pointer in
-        pointer?.assumingMemoryBound(to: ((Void) -> Void).self).pointee()
+// keeps the closure alive until the new fiber takes it
+final class FiberClosure {
+    let closure: (Void) -> Void
+
+    init(_ closure: @escaping (Void) -> Void) {
+        self.closure = closure
+    }
+}
+
+@discardableResult
+public func fiber(name: String = "swift", _ closure: @escaping (Void) -> Void) -> Bool {
+    let context = Unmanaged.passRetained(FiberClosure(closure)).toOpaque()
+    let result = fiber_wrapper(name, context, { pointer in
+        guard let pointer = pointer else {
+            return
+        }
+        let closure = Unmanaged<FiberClosure>.fromOpaque(pointer).takeRetainedValue().closure
+        closure()
     })
+    guard result == 0 else {
+        Unmanaged<FiberClosure>.fromOpaque(context).release()
+        return false
+    }
+    return true
 }
 
 @inline(__always)
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import Tarantool
+
+// Encoded MessagePack living in box_txn_alloc memory,
+// released with the fiber region on commit / rollback / fiber gc
+struct RegionBytes {
+    let start: UnsafePointer<CChar>
+    let count: Int
+
+    var end: UnsafePointer<CChar> {
+        return start + count
+    }
+}
+
+final class RegionWriter: MessagePackWriter {
+    var pointer: UnsafeMutablePointer<UInt8>?
+    var capacity = 0
+    var count = 0
+
+    func allocate(_ size: Int) throws {
+        // will be deallocated on the fiber death
+        guard let buffer = box_txn_alloc(size) else {
+            throw TarantoolError.notEnoughMemory
+        }
+        pointer = buffer.assumingMemoryBound(to: UInt8.self)
+        capacity = size
+        count = 0
+    }
+
+    func write(_ byte: UInt8) {
+        precondition(count < capacity)
+        pointer![count] = byte
+        count += 1
+    }
+
+    func write(_ bytes: UnsafeBufferPointer<UInt8>) {
+        guard let source = bytes.baseAddress, bytes.count > 0 else {
+            return
+        }
+        precondition(count + bytes.count <= capacity)
+        (pointer! + count).initialize(from: source, count: bytes.count)
+        count += bytes.count
+    }
+
+    var bytes: RegionBytes {
+        let start = UnsafeRawPointer(pointer!).assumingMemoryBound(to: CChar.self)
+        return RegionBytes(start: start, count: count)
+    }
+}
+
+extension Box {
+    // tx thread only and encoding never yields, so one pair is enough
+    static let counter = MessagePackCounter()
+    static let region = RegionWriter()
+
+    // sizes the value first, then encodes it straight into region memory
+    static func encode(_ tuple: Tuple) throws -> RegionBytes {
+        return try encode { writer in
+            writer.encode(tuple)
+        }
+    }
+
+    // write is called twice: to size the value and to encode it
+    static func encode(_ write: (MessagePackWriter) -> Void) throws -> RegionBytes {
+        counter.count = 0
+        write(counter)
+        try region.allocate(max(counter.count, 1))
+        write(region)
+        return region.bytes
+    }
+}
@@ -16,19 +16,19 @@ extension Box {
             case commit, rollback
         }
 
-        fileprivate static func begin() throws {
+        static func begin() throws {
             guard box_txn_begin() == 0 else {
                 throw BoxError()
             }
         }
 
-        fileprivate static func commit() throws {
+        static func commit() throws {
             guard box_txn_commit() == 0 else {
                 throw BoxError()
             }
         }
 
-        fileprivate static func rollback() throws {
+        static func rollback() throws {
             guard box_txn_rollback() == 0 else {
                 throw BoxError()
             }
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import CTarantool
+import MessagePack
+
+// Referenced box tuple, fields are decoded in place on demand.
+// The tuple is kept alive until the view is released.
+public final class TupleView {
+    let pointer: OpaquePointer
+    // one past the last byte of the tuple msgpack, nil if it has no fields
+    let end: UnsafePointer<UInt8>?
+
+    init(_ pointer: OpaquePointer) throws {
+        guard box_tuple_ref(pointer) == 0 else {
+            throw BoxError()
+        }
+        self.pointer = pointer
+
+        // The array header may be non-minimal, so its size can't be told
+        // by the field count: the end is found by skipping the last field.
+        // It can't be longer than the whole tuple, bsize bounds the skip.
+        let count = box_tuple_field_count(pointer)
+        if count > 0, let last = box_tuple_field(pointer, count - 1) {
+            let bytes = UnsafeRawPointer(last).assumingMemoryBound(to: UInt8.self)
+            var reader = MessagePackReader(bytes: UnsafeBufferPointer(start: bytes, count: box_tuple_bsize(pointer)))
+            do {
+                try reader.skip()
+            } catch {
+                box_tuple_unref(pointer)
+                throw error
+            }
+            self.end = bytes + reader.position
+        } else {
+            self.end = nil
+        }
+    }
+
+    deinit {
+        box_tuple_unref(pointer)
+    }
+
+    public var count: Int {
+        return Int(box_tuple_field_count(pointer))
+    }
+
+    // reader bounded by the end of the tuple
+    func reader(at field: UnsafePointer<CChar>) -> MessagePackReader {
+        let bytes = UnsafeRawPointer(field).assumingMemoryBound(to: UInt8.self)
+        return MessagePackReader(bytes: UnsafeBufferPointer(start: bytes, count: end! - bytes))
+    }
+
+    // reader positioned at the field, nil if there is no such field
+    public func field(at index: Int) -> MessagePackReader? {
+        guard index >= 0, let field = box_tuple_field(pointer, UInt32(index)) else {
+            return nil
+        }
+        return reader(at: field)
+    }
+
+    public subscript(index: Int) -> MessagePack? {
+        guard var reader = field(at: index) else {
+            return nil
+        }
+        return try? reader.decode()
+    }
+
+    public func int(at index: Int) -> Int? {
+        guard var reader = field(at: index) else {
+            return nil
+        }
+        return try? reader.decodeInt()
+    }
+
+    public func string(at index: Int) -> String? {
+        guard var reader = field(at: index) else {
+            return nil
+        }
+        return try? reader.decodeString()
+    }
+
+    public func double(at index: Int) -> Double? {
+        guard var reader = field(at: index) else {
+            return nil
+        }
+        return try? reader.decodeDouble()
+    }
+
+    public func bool(at index: Int) -> Bool? {
+        guard var reader = field(at: index) else {
+            return nil
+        }
+        return try? reader.decodeBool()
+    }
+
+    public func unpack() throws -> Tuple {
+        var tuple = Tuple()
+        tuple.reserveCapacity(count)
+        for var field in self {
+            tuple.append(try field.decode())
+        }
+        return tuple
+    }
+}
+
+extension TupleView: Sequence {
+    // walks the fields with box_tuple_iterator,
+    // yields a reader positioned at each of them
+    public final class FieldIterator: IteratorProtocol {
+        let tuple: TupleView
+        let iterator: OpaquePointer
+
+        init(_ tuple: TupleView) {
+            self.tuple = tuple
+            self.iterator = box_tuple_iterator(tuple.pointer)
+        }
+
+        deinit {
+            box_tuple_iterator_free(iterator)
+        }
+
+        public func next() -> MessagePackReader? {
+            guard let field = box_tuple_next(iterator) else {
+                return nil
+            }
+            return tuple.reader(at: field)
+        }
+    }
+
+    public func makeIterator() -> FieldIterator {
+        return FieldIterator(self)
+    }
+}
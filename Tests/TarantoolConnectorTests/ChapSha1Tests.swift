@@ -0,0 +1,45 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import XCTest
+@testable import TarantoolConnector
+
+class ChapSha1Tests: XCTestCase {
+    // welcome with the salt bytes 0...31 and a valid header
+    func makeWelcome() -> Welcome {
+        var welcome = Welcome()
+        let header = [UInt8]("Tarantool 1.7.4 (Binary) 00000000-0000-0000-0000-000000000000".utf8)
+        let salt = [UInt8]("AAECAwQFBgcICQoLDA0ODxAREhMUFRYXGBkaGxwdHh8=".utf8)
+        welcome.buffer.replaceSubrange(0..<header.count, with: header)
+        welcome.buffer.replaceSubrange(64..<64+salt.count, with: salt)
+        return welcome
+    }
+
+    // sha1("tester") xor sha1(salt[0..<20] + sha1(sha1("tester")))
+    func testScramble() throws {
+        let welcome = makeWelcome()
+        XCTAssertTrue(welcome.isValid)
+        let scramble = try ChapSha1(password: "tester").withScramble(welcome: welcome) { scramble in
+            hex([UInt8](scramble))
+        }
+        XCTAssertEqual(scramble, "bdcfda5543f0bb60326d6256d811a2cfa4db9a02")
+    }
+
+    func testInvalidSalt() {
+        var welcome = makeWelcome()
+        welcome.buffer[64] = UInt8(ascii: "*")
+        XCTAssertThrowsError(try ChapSha1(password: "tester").withScramble(welcome: welcome) { _ in })
+    }
+
+    static var allTests = [
+        ("testScramble", testScramble),
+        ("testInvalidSalt", testInvalidSalt),
+    ]
+}
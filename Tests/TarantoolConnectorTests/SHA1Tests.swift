@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Tris Foundation and the project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License
+ *
+ * See LICENSE.txt in the project root for license information
+ * See CONTRIBUTORS.txt for the list of the project authors
+ */
+
+import XCTest
+@testable import TarantoolConnector
+
+func hex(_ bytes: [UInt8]) -> String {
+    return bytes.map { byte in
+        let digits = String(byte, radix: 16)
+        return byte < 16 ? "0" + digits : digits
+    }.joined()
+}
+
+class SHA1Tests: XCTestCase {
+    func sha1(_ message: [UInt8]) -> String {
+        var digest = [UInt8](repeating: 0, count: SHA1.digestSize)
+        message.withUnsafeBufferPointer { message in
+            SHA1.hash(message, into: &digest)
+        }
+        return hex(digest)
+    }
+
+    // FIPS 180 test vectors
+    func testEmpty() {
+        XCTAssertEqual(sha1([]), "da39a3ee5e6b4b0d3255bfef95601890afd80709")
+    }
+
+    func testAbc() {
+        XCTAssertEqual(sha1([UInt8]("abc".utf8)), "a9993e364706816aba3e25717850c26c9cd0d89d")
+    }
+
+    func testTwoBlocks() {
+        let message = [UInt8]("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq".utf8)
+        XCTAssertEqual(sha1(message), "84983e441c3bd26ebaae4aa1f95129e5e54670f1")
+    }
+
+    func testMillionA() {
+        let message = [UInt8](repeating: UInt8(ascii: "a"), count: 1_000_000)
+        XCTAssertEqual(sha1(message), "34aa973cd4c4daa4f61eeb2bdbad27316534016f")
+    }
+
+    // updates split off block boundaries give the same digest
+    func testChunkedUpdate() {
+        let message = [UInt8]("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq".utf8)
+        var sha1 = SHA1()
+        message.withUnsafeBufferPointer { message in
+            var offset = 0
+            for size in [1, 6, 31, 0, 17] {
+                sha1.update(UnsafeBufferPointer(start: message.baseAddress! + offset, count: size))
+                offset += size
+            }
+            sha1.update(UnsafeBufferPointer(start: message.baseAddress! + offset, count: message.count - offset))
+        }
+        var digest = [UInt8](repeating: 0, count: SHA1.digestSize)
+        sha1.finish(into: &digest)
+        XCTAssertEqual(hex(digest), "84983e441c3bd26ebaae4aa1f95129e5e54670f1")
+    }
+
+    static var allTests = [
+        ("testEmpty", testEmpty),
+        ("testAbc", testAbc),
+        ("testTwoBlocks", testTwoBlocks),
+        ("testMillionA", testMillionA),
+        ("testChunkedUpdate", testChunkedUpdate),
+    ]
+}